@@ -12,16 +12,46 @@
 // to implement your AVL tree using your own dynamically-allocated nodes,
 // with pointers connecting them, and with your own balancing algorithms
 // used.
+//
+// Every node caches the height of the subtree rooted at it, so that the
+// balance of a node can be checked in constant time.  add() descends the
+// tree iteratively, remembering the path it took, and then walks back up
+// that path updating heights and rotating where necessary.  It stops as
+// soon as it reaches a node whose height didn't change, since nothing
+// above that node can have been affected.
+//
+// The elements can also be visited in order with an Iterator, starting from
+// the smallest one or from any element, and a set of strings can find the
+// range of its elements that begin with a given prefix.  (See
+// OrderedRange.hpp.)
 
 
 #ifndef AVLSET_HPP
 #define AVLSET_HPP
+#include <string_view>
+#include "BinaryTreeIterator.hpp"
+#include "NodePool.hpp"
+#include "OrderedRange.hpp"
 #include "Set.hpp"
  
 
 template <typename T>
 class AVLSet : public Set<T>
 {
+private:
+    // An AVL tree of height h has at least F(h+2)-1 nodes, where F is the
+    // Fibonacci sequence, so no tree with fewer than 2^32 nodes is taller
+    // than this.  It bounds the length of the path add() must remember,
+    // and the stack an Iterator keeps.
+    static constexpr int MAX_HEIGHT = 64;
+
+    struct Node;
+
+public:
+    // An Iterator visits the elements of the set in ascending order.
+    // Adding an element to the set invalidates every Iterator.
+    using Iterator = BinaryTreeIterator<T, Node, MAX_HEIGHT>;
+
 public:
     // Initializes an AVLSet to be empty.
     AVLSet();
@@ -60,26 +90,63 @@ public:
     virtual bool contains(const T& element) const;
 
 
+    // containsView() is equivalent to contains(), but doesn't require the
+    // caller to build an element to look for.
+    virtual bool containsView(typename Set<T>::KeyView element) const;
+
+
     // size() returns the number of elements in the set.
     virtual unsigned int size() const;
 
 
+    // reserve() sets aside room in the node pool for the given number of
+    // nodes, so that they can be allocated contiguously.
+    virtual void reserve(unsigned int count);
+
+
+    // forEachInOrder() calls the given function once with each element in
+    // the set, in ascending order.  This function runs in O(n) time.
+    template <typename Visitor>
+    void forEachInOrder(Visitor visit) const;
+
+
+    // begin() and end() return Iterators positioned at the smallest element
+    // and just past the largest one.
+    Iterator begin() const;
+    Iterator end() const;
+
+
+    // lowerBound() returns an Iterator positioned at the smallest element
+    // that isn't less than the given one, or end() if there's no such
+    // element.  This function always runs in O(log n) time.
+    Iterator lowerBound(typename Set<T>::KeyView element) const;
+
+
+    // prefixRange() returns the range of the elements that begin with the
+    // given prefix, which is meaningful only for a set of strings.  This
+    // function always runs in O(log n) time, and visiting the k elements in
+    // the range takes O(k) more.
+    OrderedRange<Iterator> prefixRange(std::string_view prefix) const;
+
+
 private: 
     struct Node
     {
         T key; 
         Node* left=nullptr; 
         Node* right=nullptr; 
+        int height=1;
     };
+    NodePool<Node> pool;
 
     Node* root=nullptr; 
     int node_size=0; 
-    void destroyAll(Node* L); 
+    void destroyAll();
     Node* copyAll(Node* L);
-    Node* addNode(Node* L, const T& element);
     Node* rotation(Node* L);
-    int height(Node* L); 
-    int height_diff(Node* L);
+    static int height(Node* L); 
+    static int height_diff(Node* L);
+    static void update_height(Node* L);
     Node* LL_rotation(Node* L);
     Node* LR_rotation(Node* L);
     Node* RR_rotation(Node* L);
@@ -98,7 +165,7 @@ AVLSet<T>::AVLSet()
 template <typename T>
 AVLSet<T>::~AVLSet()
 {
-    destroyAll(root);
+    destroyAll();
 }
 
 
@@ -113,6 +180,7 @@ AVLSet<T>::AVLSet(const AVLSet& s)
 template <typename T>
 AVLSet<T>::AVLSet(AVLSet&& s)
 {
+    pool.swap(s.pool);
     std:: swap(root, s.root);
     std:: swap(node_size,s.node_size);
 
@@ -122,9 +190,12 @@ AVLSet<T>::AVLSet(AVLSet&& s)
 template <typename T>
 AVLSet<T>& AVLSet<T>::operator=(const AVLSet& s)
 {
-    destroyAll(root);
-    root=copyAll(s.root);
-    node_size=s.node_size; 
+    if (this != &s)
+    {
+        destroyAll();
+        root=copyAll(s.root);
+        node_size=s.node_size;
+    }
     return *this;
 }
 
@@ -132,6 +203,7 @@ AVLSet<T>& AVLSet<T>::operator=(const AVLSet& s)
 template <typename T>
 AVLSet<T>& AVLSet<T>::operator=(AVLSet&& s)
 {
+    pool.swap(s.pool);
     std::swap(root,s.root);
     std::swap(node_size,s.node_size);
     return *this;
@@ -148,13 +220,54 @@ bool AVLSet<T>::isImplemented() const
 template <typename T>
 void AVLSet<T>::add(const T& element)
 {
-    root=addNode(root,element); 
+    Node** path[MAX_HEIGHT];
+    int depth=0;
+    Node** link=&root;
+
+    while(*link!=nullptr)
+    {
+        path[depth++]=link;
+        if(element<(*link)->key)
+        {
+            link=&(*link)->left;
+        }
+        else if((*link)->key<element)
+        {
+            link=&(*link)->right;
+        }
+        else
+        {
+            return;
+        }
+    }
+
+    *link=pool.create();
+    (*link)->key=element;
     node_size++; 
+
+    while(depth>0)
+    {
+        Node** at=path[--depth];
+        int old_height=(*at)->height;
+        update_height(*at);
+        *at=rotation(*at);
+        if((*at)->height==old_height)
+        {
+            break;
+        }
+    }
 }
 
 
 template <typename T>
 bool AVLSet<T>::contains(const T& element) const
+{
+    return AVLSet<T>::containsView(element);
+}
+
+
+template <typename T>
+bool AVLSet<T>::containsView(typename Set<T>::KeyView element) const
 {
     Node* curr=root; 
 
@@ -183,28 +296,70 @@ unsigned int AVLSet<T>::size() const
 }
 
 
-template<typename T>
-int AVLSet<T>:: height(Node* L)
+template <typename T>
+void AVLSet<T>::reserve(unsigned int count)
 {
-    int node_height=0; 
-    if(L==nullptr)
+    if(count>static_cast<unsigned int>(node_size))
     {
-        return 0;
+        pool.reserve(count-node_size);
     }
-    else
+}
+
+
+template <typename T>
+template <typename Visitor>
+void AVLSet<T>::forEachInOrder(Visitor visit) const
+{
+    Node* stack[MAX_HEIGHT];
+    int depth=0;
+    Node* curr=root;
+
+    while(curr!=nullptr || depth>0)
     {
-        int left_height=height(L->left);
-        int right_height=height(L->right);
-        if(left_height>right_height)
+        while(curr!=nullptr)
         {
-            node_height=left_height+1; 
-        }
-        else
-        {
-            node_height=right_height+1;
+            stack[depth++]=curr;
+            curr=curr->left;
         }
+        curr=stack[--depth];
+        visit(curr->key);
+        curr=curr->right;
     }
-    return node_height;
+}
+
+
+template <typename T>
+typename AVLSet<T>::Iterator AVLSet<T>::begin() const
+{
+    return Iterator::first(root);
+}
+
+
+template <typename T>
+typename AVLSet<T>::Iterator AVLSet<T>::end() const
+{
+    return Iterator{};
+}
+
+
+template <typename T>
+typename AVLSet<T>::Iterator AVLSet<T>::lowerBound(typename Set<T>::KeyView element) const
+{
+    return Iterator::lowerBound(root, element);
+}
+
+
+template <typename T>
+OrderedRange<typename AVLSet<T>::Iterator> AVLSet<T>::prefixRange(std::string_view prefix) const
+{
+    return makePrefixRange(*this, prefix);
+}
+
+
+template<typename T>
+int AVLSet<T>:: height(Node* L)
+{
+    return L==nullptr ? 0 : L->height;
 }
 
 
@@ -215,6 +370,15 @@ int AVLSet<T>::height_diff(Node* L)
 }
 
 
+template<typename T>
+void AVLSet<T>::update_height(Node* L)
+{
+    int left_height=height(L->left);
+    int right_height=height(L->right);
+    L->height=(left_height>right_height ? left_height : right_height)+1;
+}
+
+
 template< typename T>
 typename AVLSet<T>::Node* AVLSet<T>::rotation(Node* L)
 {
@@ -251,6 +415,8 @@ typename AVLSet<T>::Node* AVLSet<T>::LL_rotation(Node* L)
     Node* temp=L->left; 
     L->left=temp->right; 
     temp->right=L; 
+    update_height(L);
+    update_height(temp);
     return temp; 
 }
 
@@ -261,6 +427,8 @@ typename AVLSet<T>::Node* AVLSet<T>::RR_rotation(Node* L)
     Node* temp=L->right; 
     L->right=temp->left; 
     temp->left=L; 
+    update_height(L);
+    update_height(temp);
     return temp; 
 }
 
@@ -285,60 +453,29 @@ typename AVLSet<T>::Node* AVLSet<T>::RL_rotation(Node* L)
 }
 
 
-template< typename T>
-typename AVLSet<T>::Node* AVLSet<T>::addNode(Node* L, const T& element) 
-{
-    if(L==nullptr)
-    {
-        L= new Node();
-        L->key=element; 
-        return L;  
-    }
-    else
-    {
-        if(element<L->key)
-        {
-            L->left=addNode(L->left,element);
-            L=rotation(L);
-
-        }
-        if(element>L->key)
-        {
-            L->right=addNode(L->right,element);
-            L=rotation(L);
-        }
-        return L; 
-    }
-}
-
-
 template<typename T>
 typename AVLSet<T>::Node* AVLSet<T>::copyAll(Node* L)  
 {
-    Node* curr=new Node();
     if(L==nullptr)
     {
         return nullptr; 
     }
-    else
-    {
-        curr->key=L->key; 
-        curr->left=copyAll(L->left); 
-        curr->right=copyAll(L->right); 
-    } 
+    Node* curr=pool.create();
+    curr->key=L->key; 
+    curr->height=L->height;
+    curr->left=copyAll(L->left); 
+    curr->right=copyAll(L->right); 
     return curr; 
 }
 
 
+// Every node lives in the pool, so the whole tree is released at once
+// without having to traverse it.
 template<typename T>
-void AVLSet<T>::destroyAll(Node*L) 
+void AVLSet<T>::destroyAll() 
 {
-    if(L!=nullptr)
-    {
-        destroyAll(L->left);
-        destroyAll(L->right);
-        delete L; 
-    }
+    pool.clear();
+    root=nullptr;
 }
 
 
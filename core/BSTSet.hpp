@@ -4,22 +4,60 @@
 // Project #3: Set the Controls for the Heart of the Sun
 //
 // A BSTSet is an implementation of a Set that is a binary search tree,
-// albeit one that makes no attempt to remain balanced.  (You explicitly
-// should not do any balancing here; do that in AVLSet instead, if you
-// choose to work on that one.)
+// albeit one that doesn't rebalance itself on every insertion, the way
+// AVLSet does.
 //
 // You are not permitted to use the containers in the C++ Standard Library
 // (such as std::set, std::map, or std::vector).  Instead, you'll need
 // to implement your binary search tree using your own dynamically-allocated
 // nodes, with pointers connecting them.
+//
+// Word files are usually sorted, which would turn an ordinary binary search
+// tree into a linked list.  So the BSTSet keeps track of its largest node,
+// and an element larger than every other is simply hung to the right of it,
+// without a search.  The resulting "vine" is straightened out when the set
+// is frozen, by rebuilding the whole tree into a perfectly balanced one with
+// the Day-Stout-Warren algorithm, which takes O(n) time and no extra memory.
+//
+// Any search that ends up deeper than about twice the height of a balanced
+// tree is charged for the extra steps it took.  Once those charges add up
+// to the size of the tree -- the cost of rebuilding it -- the tree is
+// rebuilt, so near-sorted input, or a set that's never frozen, can't keep a
+// degenerate tree for long.  Nothing here is recursive, so no tree is too
+// deep to add to, copy or destroy.
+//
+// The elements can also be visited in order with an Iterator, starting from
+// the smallest one or from any element, and a set of strings can find the
+// range of its elements that begin with a given prefix.  (See
+// OrderedRange.hpp.)  An Iterator's stack has a fixed size, so a tree that
+// has grown deeper than depth_limit is rebuilt before one is created.
 #ifndef BSTSET_HPP
 #define BSTSET_HPP
+#include <algorithm>
+#include <string_view>
+#include <utility>
+#include "BinaryTreeIterator.hpp"
+#include "NodePool.hpp"
+#include "OrderedRange.hpp"
 #include "Set.hpp"
 
 
 template <typename T>
 class BSTSet : public Set<T>
 {
+private:
+    // depth_limit is never more than 62 for a set whose size fits in an
+    // int, and an Iterator is only created for a tree no deeper than that.
+    static constexpr int MAX_HEIGHT=64;
+
+    struct Node;
+
+public:
+    // An Iterator visits the elements of the set in ascending order.
+    // Anything that may reshape the tree -- add(), contains() or freeze() --
+    // invalidates every Iterator.
+    using Iterator=BinaryTreeIterator<T, Node, MAX_HEIGHT>;
+
 public:
     // Initializes a BSTSet to be empty.
     BSTSet();
@@ -27,7 +65,8 @@ public:
     // Cleans up the BSTSet so that it leaks no memory.
     virtual ~BSTSet();
 
-    // Initializes a new BSTSet to be a copy of an existing one.
+    // Initializes a new BSTSet to be a copy of an existing one.  The copy
+    // is perfectly balanced, whatever the shape of the original.
     BSTSet(const BSTSet& s);
 
     // Initializes a new BSTSet whose contents are moved from an
@@ -47,75 +86,144 @@ public:
 
 
     // add() adds an element to the set.  If the element is already in the set,
-    // this function has no effect.  This function runs in O(n) time when there
-    // are n elements in the binary search tree, and is sometimes as fast as
-    // O(log n) (when the tree is relatively balanced).
+    // this function has no effect.  Adding an element larger than every other
+    // takes constant time.  Otherwise, this function runs in time proportional
+    // to the depth of the tree, which is O(log n) amortized, since deep trees
+    // are rebuilt.
     virtual void add(const T& element);
 
 
     // contains() returns true if the given element is already in the set,
-    // false otherwise.  This function runs in O(n) time when there
-    // are n elements in the binary search tree, and is sometimes as fast as
-    // O(log n) (when the tree is relatively balanced).
+    // false otherwise.  This function runs in time proportional to the depth
+    // of the tree, which is O(log n) once the tree is frozen and O(log n)
+    // amortized otherwise.
     virtual bool contains(const T& element) const;
 
 
+    // containsView() is equivalent to contains(), but doesn't require the
+    // caller to build an element to look for.
+    virtual bool containsView(typename Set<T>::KeyView element) const;
+
+
     // size() returns the number of elements in the set.
     virtual unsigned int size() const;
 
 
+    // reserve() sets aside room in the node pool for the given number of
+    // nodes, so that they can be allocated contiguously.
+    virtual void reserve(unsigned int count);
+
+
+    // freeze() rebuilds the tree into a perfectly balanced one, unless it's
+    // already shallow enough.  This function runs in O(n) time.
+    virtual void freeze();
+
+
+    // forEachInOrder() calls the given function once with each element in
+    // the set, in ascending order.  This function runs in O(n) time.
+    template <typename Visitor>
+    void forEachInOrder(Visitor visit) const;
+
+
+    // begin() and end() return Iterators positioned at the smallest element
+    // and just past the largest one.  begin() rebuilds the tree first if
+    // it's too deep.
+    Iterator begin() const;
+    Iterator end() const;
+
+
+    // lowerBound() returns an Iterator positioned at the smallest element
+    // that isn't less than the given one, or end() if there's no such
+    // element.  Like begin(), it rebuilds the tree first if it's too deep,
+    // so it runs in O(log n) amortized time.
+    Iterator lowerBound(typename Set<T>::KeyView element) const;
+
+
+    // prefixRange() returns the range of the elements that begin with the
+    // given prefix, which is meaningful only for a set of strings.  This
+    // function runs in O(log n) amortized time, and visiting the k elements
+    // in the range takes O(k) more.
+    OrderedRange<Iterator> prefixRange(std::string_view prefix) const;
+
+
 private:
     struct Node
     {
-        T key; 
-        Node* left=nullptr; 
-        Node* right=nullptr; 
+        T key;
+        Node* left=nullptr;
+        Node* right=nullptr;
     };
-    Node* root=nullptr; 
-    int node_size=0; 
-
-    Node* copyAll(Node* L);
-    void destroyAll(Node* L); 
-    Node* addNode(Node* L, const T& element);
+    NodePool<Node> pool;
+
+    // Searching may rebuild the tree, so the shape of the tree can change
+    // even when its contents can't.
+    mutable Node* root=nullptr;
+    Node* rightmost=nullptr;
+    mutable int rightmost_depth=0;
+    int node_size=0;
+
+    // depth_limit is about twice the height of a balanced tree of this
+    // size, max_depth is the depth of the deepest node added since the last
+    // rebuild, and excess is the number of steps that searches have taken
+    // below depth_limit since then.
+    int depth_limit=0;
+    mutable int max_depth=0;
+    mutable int excess=0;
+
+    template <typename Visitor>
+    static void inOrder(Node* L, Visitor visit);
+
+    void copyAll(const BSTSet& s);
+    void destroyAll();
+    void charge(int depth) const;
+    void rebuild() const;
+    static void compress(Node* L, int count);
 };
 
 
 template <typename T>
-BSTSet<T>::BSTSet()   
+BSTSet<T>::BSTSet()
 	:root(nullptr)
-{ 
+{
 }
 
 
 template <typename T>
-BSTSet<T>::~BSTSet()  
+BSTSet<T>::~BSTSet()
 {
-    destroyAll(root);
+    destroyAll();
 }
 
 
 template <typename T>
 BSTSet<T>::BSTSet(const BSTSet& s)
 {
-    root=copyAll(s.root);
-    node_size=s.node_size; 
+    copyAll(s);
 }
 
 
 template <typename T>
 BSTSet<T>::BSTSet(BSTSet&& s)
 {
+    pool.swap(s.pool);
     std::swap(root,s.root);
+    std::swap(rightmost,s.rightmost);
+    std::swap(rightmost_depth,s.rightmost_depth);
     std::swap(node_size,s.node_size);
+    std::swap(depth_limit,s.depth_limit);
+    std::swap(max_depth,s.max_depth);
+    std::swap(excess,s.excess);
 }
 
 
 template <typename T>
 BSTSet<T>& BSTSet<T>::operator=(const BSTSet& s)
 {
-    destroyAll(root); 
-    root=copyAll(s.root);
-    node_size=s.node_size; 
+    if (this != &s)
+    {
+        destroyAll();
+        copyAll(s);
+    }
     return *this;
 }
 
@@ -123,109 +231,363 @@ BSTSet<T>& BSTSet<T>::operator=(const BSTSet& s)
 template <typename T>
 BSTSet<T>& BSTSet<T>::operator=(BSTSet&& s)
 {
+    pool.swap(s.pool);
     std::swap(root, s.root);
+    std::swap(rightmost,s.rightmost);
+    std::swap(rightmost_depth,s.rightmost_depth);
     std::swap(node_size,s.node_size);
+    std::swap(depth_limit,s.depth_limit);
+    std::swap(max_depth,s.max_depth);
+    std::swap(excess,s.excess);
     return *this;
 }
 
 
 template <typename T>
-bool BSTSet<T>::isImplemented() const  
+bool BSTSet<T>::isImplemented() const
 {
     return true;
 }
 
 
 template <typename T>
-void BSTSet<T>::add(const T& element) 
-{  
-    root=addNode(root,element);
+void BSTSet<T>::add(const T& element)
+{
+    Node** link=&root;
+    int depth=1;
+    bool appending=rightmost!=nullptr && rightmost->key<element;
+
+    if(appending)
+    {
+        // The element is larger than every other, so it belongs to the
+        // right of the largest node.
+        link=&rightmost->right;
+        depth=rightmost_depth+1;
+    }
+    else
+    {
+        while(*link!=nullptr)
+        {
+            if(element<(*link)->key)
+            {
+                link=&(*link)->left;
+            }
+            else if((*link)->key<element)
+            {
+                link=&(*link)->right;
+            }
+            else
+            {
+                charge(depth);
+                return;
+            }
+            depth++;
+        }
+    }
+
+    Node* curr=pool.create();
+    curr->key=element;
+    *link=curr;
     node_size++;
+
+    if(appending || rightmost==nullptr)
+    {
+        rightmost=curr;
+        rightmost_depth=depth;
+    }
+    if(depth>max_depth)
+    {
+        max_depth=depth;
+    }
+    if(((node_size+1)&node_size)==0)
+    {
+        depth_limit+=2;
+    }
+
+    // Appending took constant time however deep it went, so only a search
+    // is charged for its depth.
+    if(!appending)
+    {
+        charge(depth);
+    }
 }
 
 
 template <typename T>
-bool BSTSet<T>::contains(const T& element) const 
+bool BSTSet<T>::contains(const T& element) const
 {
-    Node* curr=root; 
+    return BSTSet<T>::containsView(element);
+}
+
+
+template <typename T>
+bool BSTSet<T>::containsView(typename Set<T>::KeyView element) const
+{
+    Node* curr=root;
+    int depth=1;
     while(curr!=nullptr)
     {
         if(curr->key ==element)
         {
-            return true; 
+            charge(depth);
+            return true;
         }
         else
             if(curr->key>element)
             {
-                curr=curr->left; 
+                curr=curr->left;
             }
             else
-                curr=curr->right; 
+                curr=curr->right;
+        depth++;
     }
+    charge(depth);
     return false;
 }
 
 
 template <typename T>
-unsigned int BSTSet<T>::size() const 
+unsigned int BSTSet<T>::size() const
 {
     return node_size;
 }
 
 
-template<typename T>
-typename BSTSet<T>::Node* BSTSet<T>::addNode(Node* L, const T& element)
+template <typename T>
+void BSTSet<T>::reserve(unsigned int count)
 {
-    if(L==nullptr)
+    if(count>static_cast<unsigned int>(node_size))
     {
-        L= new Node();
-        L->key=element; 
-        return L;  
+        pool.reserve(count-node_size);
     }
-    else
-    {   
-        if(element<L->key)
+}
+
+
+template <typename T>
+void BSTSet<T>::freeze()
+{
+    if(max_depth>depth_limit)
+    {
+        rebuild();
+    }
+}
+
+
+template <typename T>
+template <typename Visitor>
+void BSTSet<T>::forEachInOrder(Visitor visit) const
+{
+    inOrder(root, visit);
+}
+
+
+template <typename T>
+typename BSTSet<T>::Iterator BSTSet<T>::begin() const
+{
+    if(max_depth>depth_limit)
+    {
+        rebuild();
+    }
+    return Iterator::first(root);
+}
+
+
+template <typename T>
+typename BSTSet<T>::Iterator BSTSet<T>::end() const
+{
+    return Iterator{};
+}
+
+
+template <typename T>
+typename BSTSet<T>::Iterator BSTSet<T>::lowerBound(typename Set<T>::KeyView element) const
+{
+    if(max_depth>depth_limit)
+    {
+        rebuild();
+    }
+    return Iterator::lowerBound(root, element);
+}
+
+
+template <typename T>
+OrderedRange<typename BSTSet<T>::Iterator> BSTSet<T>::prefixRange(std::string_view prefix) const
+{
+    return makePrefixRange(*this, prefix);
+}
+
+
+// inOrder() visits the subtree rooted at the given node in order.  The tree
+// may be deep, so the stack of nodes whose right subtrees are still to be
+// visited lives on the heap and grows as needed.
+template <typename T>
+template <typename Visitor>
+void BSTSet<T>::inOrder(Node* L, Visitor visit)
+{
+    int capacity=64;
+    Node** stack=new Node*[capacity];
+    int depth=0;
+    Node* curr=L;
+
+    while(curr!=nullptr || depth>0)
+    {
+        while(curr!=nullptr)
         {
-            L->left=addNode(L->left,element);
+            if(depth==capacity)
+            {
+                Node** bigger=new Node*[capacity*2];
+                std::copy(stack, stack+capacity, bigger);
+                delete[] stack;
+                stack=bigger;
+                capacity*=2;
+            }
+            stack[depth++]=curr;
+            curr=curr->left;
         }
-        if(element>L->key)
+        curr=stack[--depth];
+        visit(curr->key);
+        curr=curr->right;
+    }
+
+    delete[] stack;
+}
+
+
+// copyAll() copies the elements in order onto a vine, which is then
+// rebuilt into a balanced tree, so no recursion is needed however deep
+// the original is.
+template<typename T>
+void BSTSet<T>::copyAll(const BSTSet& s)
+{
+    Node pseudo;
+    Node* tail=&pseudo;
+
+    inOrder(s.root,
+        [&](const T& key)
         {
-            L->right=addNode(L->right,element);
+            Node* curr=pool.create();
+            curr->key=key;
+            tail->right=curr;
+            tail=curr;
+        });
+
+    root=pseudo.right;
+    rightmost=s.rightmost!=nullptr ? tail : nullptr;
+    rightmost_depth=s.node_size;
+    node_size=s.node_size;
+    depth_limit=s.depth_limit;
+    max_depth=s.node_size;
+    excess=0;
+
+    freeze();
+}
+
+
+// Every node lives in the pool, so the whole tree is released at once
+// without having to traverse it.
+template<typename T>
+void BSTSet<T>::destroyAll()
+{
+    pool.clear();
+    root=nullptr;
+    rightmost=nullptr;
+    node_size=0;
+    depth_limit=0;
+    max_depth=0;
+    excess=0;
+}
+
+
+// charge() records a search that reached the given depth, rebuilding the
+// tree once searches have wasted as many steps as a rebuild would take.
+template<typename T>
+void BSTSet<T>::charge(int depth) const
+{
+    if(depth>depth_limit)
+    {
+        excess+=depth-depth_limit;
+
+        if(excess>node_size)
+        {
+            rebuild();
         }
-        return L; 
     }
 }
 
 
+// rebuild() uses the Day-Stout-Warren algorithm: rotations first turn the
+// tree into a vine of right children, in order, and then a series of
+// left rotations down the vine compresses it into a balanced tree.
 template<typename T>
-typename BSTSet<T>::Node* BSTSet<T>::copyAll(Node* L)   
-{ 
-    Node* curr=new Node();
-    if(L==nullptr)
+void BSTSet<T>::rebuild() const
+{
+    Node pseudo;
+    pseudo.right=root;
+
+    Node* tail=&pseudo;
+    Node* rest=tail->right;
+
+    while(rest!=nullptr)
     {
-        return nullptr; 
+        if(rest->left==nullptr)
+        {
+            tail=rest;
+            rest=rest->right;
+        }
+        else
+        {
+            Node* temp=rest->left;
+            rest->left=temp->right;
+            temp->right=rest;
+            rest=temp;
+            tail->right=temp;
+        }
     }
-    else
+
+    int size=node_size;
+    int full=1;
+    while(full<=size+1)
+    {
+        full*=2;
+    }
+    full=full/2-1;
+
+    compress(&pseudo, size-full);
+    for(size=full; size>1; size/=2)
     {
-        curr->key=L->key; 
-        curr->left=copyAll(L->left); 
-        curr->right=copyAll(L->right); 
-    } 
-    return curr; 
+        compress(&pseudo, size/2);
+    }
+
+    root=pseudo.right;
+
+    max_depth=0;
+    for(int n=node_size; n>0; n>>=1)
+    {
+        max_depth++;
+    }
+
+    rightmost_depth=0;
+    for(Node* curr=root; curr!=nullptr; curr=curr->right)
+    {
+        rightmost_depth++;
+    }
+    excess=0;
 }
 
 
 template<typename T>
-void BSTSet<T>::destroyAll(Node*L)  
+void BSTSet<T>::compress(Node* L, int count)
 {
-    if(L!=nullptr)
+    Node* scanner=L;
+    for(int i=0; i<count; i++)
     {
-        destroyAll(L->left);
-        destroyAll(L->right);
-        delete L; 
+        Node* child=scanner->right;
+        scanner->right=child->right;
+        scanner=scanner->right;
+        child->right=scanner->left;
+        scanner->left=child;
     }
 }
 
 
 #endif // BSTSET_HPP
-
@@ -0,0 +1,822 @@
+// BTreeSet.hpp
+//
+// ICS 46 Spring 2017
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A BTreeSet is an implementation of a Set that is a B+ tree.  Rather than
+// one key per node, as in AVLSet and BSTSet, each node holds up to NODE_KEYS
+// keys side by side in an array, so a search reads a few adjacent cache
+// lines at each level instead of following a pointer for every comparison.
+// With sixteen or more keys per node, a tree of hundreds of thousands of
+// words is only four or five levels deep.
+//
+// Every element is stored in a leaf, and the leaves are linked together in
+// ascending order.  The inner nodes hold only separators: an inner node
+// with k keys has k + 1 children, and its i-th key is the smallest element
+// in the subtree of its (i + 1)-th child.  All of the leaves are at the same
+// depth, and the tree grows upward, by splitting the root.
+//
+// Word files are usually sorted, so add() has a fast path for an element
+// larger than any already in the set: it walks straight down the right edge
+// of the tree without searching any nodes, and when the rightmost node is
+// full, it leaves every existing key where it is and starts a new node with
+// only the new one.  Loading sorted input therefore leaves every node but
+// those on the right edge completely full, just as if it had been bulk
+// loaded.  Elements that arrive out of order split nodes in half, as usual.
+//
+// The links between leaves make iterating in order simple: an Iterator is
+// just a leaf and an index into its keys.  lowerBound() finds the leaf
+// where an element would be with the same descent that contains() makes,
+// and a set of strings uses it to find the range of its elements that
+// begin with a given prefix.  (See OrderedRange.hpp.)
+
+#ifndef BTREESET_HPP
+#define BTREESET_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+#include <utility>
+#include "NodePool.hpp"
+#include "OrderedRange.hpp"
+#include "Set.hpp"
+
+
+
+template <typename T>
+class BTreeSet : public Set<T>
+{
+public:
+    // The greatest number of keys in a node.  Nodes of small keys have
+    // about 256 bytes of keys (four cache lines), but never fewer than 16
+    // or more than 32 keys.
+    static constexpr unsigned int NODE_KEYS =
+        256 / sizeof(T) < 16 ? 16 : (256 / sizeof(T) > 32 ? 32 : 256 / sizeof(T));
+
+    // The greatest height of the tree.  Every node that isn't on the right
+    // edge of the tree is at least half full, so no tree that an unsigned
+    // int can count is nearly this tall.
+    static constexpr unsigned int MAX_HEIGHT = 16;
+
+private:
+    struct Leaf;
+
+public:
+    // An Iterator visits the elements of the set in ascending order.
+    // Adding an element to the set invalidates every Iterator.
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+    public:
+        // Initializes an Iterator that's past the end of any set.
+        Iterator();
+
+        const T& operator*() const;
+        const T* operator->() const;
+
+        Iterator& operator++();
+        Iterator operator++(int);
+
+        bool operator==(const Iterator& other) const;
+        bool operator!=(const Iterator& other) const;
+
+    private:
+        friend class BTreeSet;
+
+        Iterator(const Leaf* leaf, unsigned int index);
+
+        const Leaf* leaf;
+        unsigned int index;
+    };
+
+public:
+    // Initializes a BTreeSet to be empty.
+    BTreeSet();
+
+    // Cleans up the BTreeSet so that it leaks no memory.
+    virtual ~BTreeSet();
+
+    // Initializes a new BTreeSet to be a copy of an existing one.
+    BTreeSet(const BTreeSet& s);
+
+    // Initializes a new BTreeSet whose contents are moved from an
+    // expiring one.
+    BTreeSet(BTreeSet&& s);
+
+    // Assigns an existing BTreeSet into another.
+    BTreeSet& operator=(const BTreeSet& s);
+
+    // Assigns an expiring BTreeSet into another.
+    BTreeSet& operator=(BTreeSet&& s);
+
+
+    virtual bool isImplemented() const;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  This function runs in O(log n)
+    // time, and adding an element larger than all of the others avoids
+    // searching within the nodes entirely.
+    virtual void add(const T& element);
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  This function runs in O(log n) time, visiting one
+    // node at each level of the tree.
+    virtual bool contains(const T& element) const;
+
+
+    // containsView() is equivalent to contains(), but doesn't require the
+    // caller to build an element to look for.
+    virtual bool containsView(typename Set<T>::KeyView element) const;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const;
+
+
+    // reserve() sets aside room in the node pools for the leaves (and the
+    // inner nodes above them) that the given number of elements would fill
+    // if they arrived in sorted order.
+    virtual void reserve(unsigned int count);
+
+
+    // forEachInOrder() calls the given function once with each element in
+    // the set, in ascending order, by following the links between leaves.
+    // This function runs in O(n) time.
+    template <typename Visitor>
+    void forEachInOrder(Visitor visit) const;
+
+
+    // begin() and end() return Iterators positioned at the smallest element
+    // and just past the largest one.
+    Iterator begin() const;
+    Iterator end() const;
+
+
+    // lowerBound() returns an Iterator positioned at the smallest element
+    // that isn't less than the given one, or end() if there's no such
+    // element.  This function runs in O(log n) time.
+    Iterator lowerBound(typename Set<T>::KeyView element) const;
+
+
+    // prefixRange() returns the range of the elements that begin with the
+    // given prefix, which is meaningful only for a set of strings.  This
+    // function runs in O(log n) time, and visiting the k elements in the
+    // range takes O(k) more.
+    OrderedRange<Iterator> prefixRange(std::string_view prefix) const;
+
+
+private:
+    struct Node
+    {
+        unsigned int count = 0;
+        T keys[NODE_KEYS];
+    };
+
+    struct Leaf : public Node
+    {
+        Leaf* next = nullptr;
+    };
+
+    struct Inner : public Node
+    {
+        Node* children[NODE_KEYS + 1];
+    };
+
+    NodePool<Leaf> leaves;
+    NodePool<Inner> inners;
+
+    Node* root;
+    Leaf* last_leaf;
+    unsigned int tree_height;
+    unsigned int tree_size;
+
+
+private:
+    static unsigned int lowerBound(const Node* node, typename Set<T>::KeyView element);
+    static unsigned int upperBound(const Node* node, typename Set<T>::KeyView element);
+
+    bool insertIntoLeaf(
+        Leaf* leaf, unsigned int index, const T& element, bool appending,
+        T& separator, Node*& right);
+
+    bool insertIntoInner(
+        Inner* inner, unsigned int index, bool appending,
+        T& separator, Node*& right);
+
+    Node* copyAll(const Node* node, unsigned int height, Leaf*& previous);
+    void destroyAll();
+};
+
+
+
+template <typename T>
+BTreeSet<T>::BTreeSet()
+    : root{nullptr}, last_leaf{nullptr}, tree_height{0}, tree_size{0}
+{
+}
+
+
+template <typename T>
+BTreeSet<T>::~BTreeSet()
+{
+    destroyAll();
+}
+
+
+template <typename T>
+BTreeSet<T>::BTreeSet(const BTreeSet& s)
+    : root{nullptr}, last_leaf{nullptr}, tree_height{s.tree_height}, tree_size{s.tree_size}
+{
+    if (s.root != nullptr)
+    {
+        root = copyAll(s.root, s.tree_height, last_leaf);
+    }
+}
+
+
+template <typename T>
+BTreeSet<T>::BTreeSet(BTreeSet&& s)
+    : root{nullptr}, last_leaf{nullptr}, tree_height{0}, tree_size{0}
+{
+    leaves.swap(s.leaves);
+    inners.swap(s.inners);
+    std::swap(root, s.root);
+    std::swap(last_leaf, s.last_leaf);
+    std::swap(tree_height, s.tree_height);
+    std::swap(tree_size, s.tree_size);
+}
+
+
+template <typename T>
+BTreeSet<T>& BTreeSet<T>::operator=(const BTreeSet& s)
+{
+    if (this != &s)
+    {
+        destroyAll();
+        tree_height = s.tree_height;
+        tree_size = s.tree_size;
+
+        if (s.root != nullptr)
+        {
+            root = copyAll(s.root, s.tree_height, last_leaf);
+        }
+    }
+
+    return *this;
+}
+
+
+template <typename T>
+BTreeSet<T>& BTreeSet<T>::operator=(BTreeSet&& s)
+{
+    leaves.swap(s.leaves);
+    inners.swap(s.inners);
+    std::swap(root, s.root);
+    std::swap(last_leaf, s.last_leaf);
+    std::swap(tree_height, s.tree_height);
+    std::swap(tree_size, s.tree_size);
+    return *this;
+}
+
+
+template <typename T>
+bool BTreeSet<T>::isImplemented() const
+{
+    return true;
+}
+
+
+template <typename T>
+void BTreeSet<T>::add(const T& element)
+{
+    if (root == nullptr)
+    {
+        last_leaf = leaves.create();
+        root = last_leaf;
+    }
+
+    bool appending =
+        last_leaf->count == 0 || last_leaf->keys[last_leaf->count - 1] < element;
+
+    Inner* path[MAX_HEIGHT];
+    unsigned int slots[MAX_HEIGHT];
+    Node* node = root;
+
+    for (unsigned int level = 0; level < tree_height; ++level)
+    {
+        Inner* inner = static_cast<Inner*>(node);
+        unsigned int slot = appending ? inner->count : upperBound(inner, element);
+
+        path[level] = inner;
+        slots[level] = slot;
+        node = inner->children[slot];
+    }
+
+    Leaf* leaf = static_cast<Leaf*>(node);
+    unsigned int index = appending ? leaf->count : lowerBound(leaf, element);
+
+    if (index < leaf->count && !(element < leaf->keys[index]))
+    {
+        return;
+    }
+
+    ++tree_size;
+
+    T separator;
+    Node* right;
+
+    if (!insertIntoLeaf(leaf, index, element, appending, separator, right))
+    {
+        return;
+    }
+
+    for (unsigned int level = tree_height; level > 0; --level)
+    {
+        if (!insertIntoInner(path[level - 1], slots[level - 1], appending, separator, right))
+        {
+            return;
+        }
+    }
+
+    Inner* newRoot = inners.create();
+    newRoot->count = 1;
+    newRoot->keys[0] = std::move(separator);
+    newRoot->children[0] = root;
+    newRoot->children[1] = right;
+
+    root = newRoot;
+    ++tree_height;
+}
+
+
+template <typename T>
+bool BTreeSet<T>::contains(const T& element) const
+{
+    return BTreeSet<T>::containsView(element);
+}
+
+
+template <typename T>
+bool BTreeSet<T>::containsView(typename Set<T>::KeyView element) const
+{
+    if (root == nullptr)
+    {
+        return false;
+    }
+
+    const Node* node = root;
+
+    for (unsigned int level = 0; level < tree_height; ++level)
+    {
+        const Inner* inner = static_cast<const Inner*>(node);
+        node = inner->children[upperBound(inner, element)];
+    }
+
+    unsigned int index = lowerBound(node, element);
+    return index < node->count && !(element < node->keys[index]);
+}
+
+
+template <typename T>
+unsigned int BTreeSet<T>::size() const
+{
+    return tree_size;
+}
+
+
+template <typename T>
+void BTreeSet<T>::reserve(unsigned int count)
+{
+    if (count <= tree_size)
+    {
+        return;
+    }
+
+    unsigned int nodes = (count - tree_size) / NODE_KEYS + 1;
+    leaves.reserve(nodes);
+    inners.reserve(nodes / NODE_KEYS + 1);
+}
+
+
+template <typename T>
+template <typename Visitor>
+void BTreeSet<T>::forEachInOrder(Visitor visit) const
+{
+    if (root == nullptr)
+    {
+        return;
+    }
+
+    const Node* node = root;
+
+    for (unsigned int level = 0; level < tree_height; ++level)
+    {
+        node = static_cast<const Inner*>(node)->children[0];
+    }
+
+    for (const Leaf* leaf = static_cast<const Leaf*>(node); leaf != nullptr; leaf = leaf->next)
+    {
+        for (unsigned int i = 0; i < leaf->count; ++i)
+        {
+            visit(leaf->keys[i]);
+        }
+    }
+}
+
+
+template <typename T>
+typename BTreeSet<T>::Iterator BTreeSet<T>::begin() const
+{
+    if (root == nullptr)
+    {
+        return Iterator{};
+    }
+
+    const Node* node = root;
+
+    for (unsigned int level = 0; level < tree_height; ++level)
+    {
+        node = static_cast<const Inner*>(node)->children[0];
+    }
+
+    return Iterator{static_cast<const Leaf*>(node), 0};
+}
+
+
+template <typename T>
+typename BTreeSet<T>::Iterator BTreeSet<T>::end() const
+{
+    return Iterator{};
+}
+
+
+template <typename T>
+typename BTreeSet<T>::Iterator BTreeSet<T>::lowerBound(typename Set<T>::KeyView element) const
+{
+    if (root == nullptr)
+    {
+        return Iterator{};
+    }
+
+    const Node* node = root;
+
+    for (unsigned int level = 0; level < tree_height; ++level)
+    {
+        const Inner* inner = static_cast<const Inner*>(node);
+        node = inner->children[upperBound(inner, element)];
+    }
+
+    // If every key in the leaf is smaller than the element, the first key
+    // of the next leaf is the one that's wanted.  No leaf is ever empty.
+    const Leaf* leaf = static_cast<const Leaf*>(node);
+    unsigned int index = lowerBound(leaf, element);
+
+    if (index < leaf->count)
+    {
+        return Iterator{leaf, index};
+    }
+    else
+    {
+        return Iterator{leaf->next, 0};
+    }
+}
+
+
+template <typename T>
+OrderedRange<typename BTreeSet<T>::Iterator> BTreeSet<T>::prefixRange(std::string_view prefix) const
+{
+    return makePrefixRange(*this, prefix);
+}
+
+
+template <typename T>
+BTreeSet<T>::Iterator::Iterator()
+    : leaf{nullptr}, index{0}
+{
+}
+
+
+template <typename T>
+BTreeSet<T>::Iterator::Iterator(const Leaf* leaf, unsigned int index)
+    : leaf{leaf}, index{index}
+{
+}
+
+
+template <typename T>
+const T& BTreeSet<T>::Iterator::operator*() const
+{
+    return leaf->keys[index];
+}
+
+
+template <typename T>
+const T* BTreeSet<T>::Iterator::operator->() const
+{
+    return &leaf->keys[index];
+}
+
+
+template <typename T>
+typename BTreeSet<T>::Iterator& BTreeSet<T>::Iterator::operator++()
+{
+    if (++index == leaf->count)
+    {
+        leaf = leaf->next;
+        index = 0;
+    }
+
+    return *this;
+}
+
+
+template <typename T>
+typename BTreeSet<T>::Iterator BTreeSet<T>::Iterator::operator++(int)
+{
+    Iterator previous = *this;
+    ++*this;
+    return previous;
+}
+
+
+template <typename T>
+bool BTreeSet<T>::Iterator::operator==(const Iterator& other) const
+{
+    return leaf == other.leaf && index == other.index;
+}
+
+
+template <typename T>
+bool BTreeSet<T>::Iterator::operator!=(const Iterator& other) const
+{
+    return !(*this == other);
+}
+
+
+// lowerBound() returns the index of the first key in the node that isn't
+// less than the given element, or the node's count if there is none.
+template <typename T>
+unsigned int BTreeSet<T>::lowerBound(const Node* node, typename Set<T>::KeyView element)
+{
+    unsigned int low = 0;
+    unsigned int high = node->count;
+
+    while (low < high)
+    {
+        unsigned int middle = (low + high) / 2;
+
+        if (node->keys[middle] < element)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+
+// upperBound() returns the index of the first key in the node that's
+// greater than the given element, which is also the index of the child of
+// an inner node whose subtree would contain it.
+template <typename T>
+unsigned int BTreeSet<T>::upperBound(const Node* node, typename Set<T>::KeyView element)
+{
+    unsigned int low = 0;
+    unsigned int high = node->count;
+
+    while (low < high)
+    {
+        unsigned int middle = (low + high) / 2;
+
+        if (element < node->keys[middle])
+        {
+            high = middle;
+        }
+        else
+        {
+            low = middle + 1;
+        }
+    }
+
+    return low;
+}
+
+
+// insertIntoLeaf() inserts an element into a leaf at the given index.  If
+// the leaf was already full, it's split, and the function returns true,
+// having stored the new right-hand leaf and its smallest key (the
+// separator that now belongs in the parent) into its last two parameters.
+// "appending" is true when the element is larger than every other.
+template <typename T>
+bool BTreeSet<T>::insertIntoLeaf(
+    Leaf* leaf, unsigned int index, const T& element, bool appending,
+    T& separator, Node*& right)
+{
+    if (leaf->count < NODE_KEYS)
+    {
+        for (unsigned int i = leaf->count; i > index; --i)
+        {
+            leaf->keys[i] = std::move(leaf->keys[i - 1]);
+        }
+
+        leaf->keys[index] = element;
+        ++leaf->count;
+        return false;
+    }
+
+    Leaf* newLeaf = leaves.create();
+    newLeaf->next = leaf->next;
+    leaf->next = newLeaf;
+
+    if (last_leaf == leaf)
+    {
+        last_leaf = newLeaf;
+    }
+
+    // When appending to the rightmost leaf, the full leaf stays full and
+    // the new leaf starts out holding only the new element; otherwise, the
+    // keys are divided evenly.  The keys are numbered as though the new
+    // element had already been inserted at the given index.
+    unsigned int keep = appending ? NODE_KEYS : (NODE_KEYS + 1) / 2;
+
+    for (unsigned int j = keep; j <= NODE_KEYS; ++j)
+    {
+        if (j == index)
+        {
+            newLeaf->keys[j - keep] = element;
+        }
+        else
+        {
+            newLeaf->keys[j - keep] = std::move(leaf->keys[j > index ? j - 1 : j]);
+        }
+    }
+
+    newLeaf->count = NODE_KEYS + 1 - keep;
+    leaf->count = keep;
+
+    if (index < keep)
+    {
+        for (unsigned int i = keep - 1; i > index; --i)
+        {
+            leaf->keys[i] = std::move(leaf->keys[i - 1]);
+        }
+
+        leaf->keys[index] = element;
+    }
+
+    separator = newLeaf->keys[0];
+    right = newLeaf;
+    return true;
+}
+
+
+// insertIntoInner() inserts a separator and the child to its right into an
+// inner node, at the given index.  If the node was already full, it's
+// split, and the function returns true, having replaced the separator and
+// child with the ones that now belong in the node's parent.
+template <typename T>
+bool BTreeSet<T>::insertIntoInner(
+    Inner* inner, unsigned int index, bool appending,
+    T& separator, Node*& right)
+{
+    if (inner->count < NODE_KEYS)
+    {
+        for (unsigned int i = inner->count; i > index; --i)
+        {
+            inner->keys[i] = std::move(inner->keys[i - 1]);
+            inner->children[i + 1] = inner->children[i];
+        }
+
+        inner->keys[index] = std::move(separator);
+        inner->children[index + 1] = right;
+        ++inner->count;
+        return false;
+    }
+
+    // Splitting an inner node is rare enough that it's simplest to lay
+    // out all of the keys and children in order first, then divide them.
+    T keys[NODE_KEYS + 1];
+    Node* children[NODE_KEYS + 2];
+
+    for (unsigned int j = 0; j <= NODE_KEYS; ++j)
+    {
+        if (j == index)
+        {
+            keys[j] = std::move(separator);
+        }
+        else
+        {
+            keys[j] = std::move(inner->keys[j > index ? j - 1 : j]);
+        }
+    }
+
+    for (unsigned int j = 0; j <= NODE_KEYS + 1; ++j)
+    {
+        if (j == index + 1)
+        {
+            children[j] = right;
+        }
+        else
+        {
+            children[j] = inner->children[j > index + 1 ? j - 1 : j];
+        }
+    }
+
+    unsigned int keep = appending ? NODE_KEYS : (NODE_KEYS + 1) / 2;
+    Inner* newInner = inners.create();
+
+    for (unsigned int j = 0; j < keep; ++j)
+    {
+        inner->keys[j] = std::move(keys[j]);
+        inner->children[j] = children[j];
+    }
+
+    inner->children[keep] = children[keep];
+    inner->count = keep;
+
+    for (unsigned int j = keep + 1; j <= NODE_KEYS; ++j)
+    {
+        newInner->keys[j - keep - 1] = std::move(keys[j]);
+        newInner->children[j - keep - 1] = children[j];
+    }
+
+    newInner->children[NODE_KEYS - keep] = children[NODE_KEYS + 1];
+    newInner->count = NODE_KEYS - keep;
+
+    separator = std::move(keys[keep]);
+    right = newInner;
+    return true;
+}
+
+
+// copyAll() copies the subtree rooted at the given node, whose leaves are
+// the given height below it, linking each new leaf to the one before it.
+template <typename T>
+typename BTreeSet<T>::Node* BTreeSet<T>::copyAll(
+    const Node* node, unsigned int height, Leaf*& previous)
+{
+    if (height == 0)
+    {
+        Leaf* leaf = leaves.create();
+        leaf->count = node->count;
+
+        for (unsigned int i = 0; i < node->count; ++i)
+        {
+            leaf->keys[i] = node->keys[i];
+        }
+
+        if (previous != nullptr)
+        {
+            previous->next = leaf;
+        }
+
+        previous = leaf;
+        return leaf;
+    }
+
+    const Inner* source = static_cast<const Inner*>(node);
+    Inner* inner = inners.create();
+    inner->count = source->count;
+
+    for (unsigned int i = 0; i < source->count; ++i)
+    {
+        inner->keys[i] = source->keys[i];
+    }
+
+    for (unsigned int i = 0; i <= source->count; ++i)
+    {
+        inner->children[i] = copyAll(source->children[i], height - 1, previous);
+    }
+
+    return inner;
+}
+
+
+// Every node lives in one of the pools, so the whole tree is released at
+// once without having to traverse it.
+template <typename T>
+void BTreeSet<T>::destroyAll()
+{
+    leaves.clear();
+    inners.clear();
+    root = nullptr;
+    last_leaf = nullptr;
+    tree_height = 0;
+    tree_size = 0;
+}
+
+
+
+#endif // BTREESET_HPP
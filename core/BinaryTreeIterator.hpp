@@ -0,0 +1,180 @@
+// BinaryTreeIterator.hpp
+//
+// ICS 46 Spring 2017
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A BinaryTreeIterator visits the keys of a binary search tree in
+// ascending order.  It's shared by the sets that are binary search trees
+// (AVLSet and BSTSet), whose nodes have no parent pointers, so it keeps its
+// own stack: the node whose key it's positioned at, on top of every
+// ancestor of that node whose key is larger, which are the nodes it will
+// return to once it's finished with their left subtrees.  Moving forward
+// pops the top node and pushes the leftmost path of its right subtree, so
+// it takes amortized constant time, and the stack never holds more nodes
+// than the tree is tall.
+//
+// The tree must be no taller than MaxHeight, and the iterator is
+// invalidated by anything that reshapes the tree.
+
+#ifndef BINARYTREEITERATOR_HPP
+#define BINARYTREEITERATOR_HPP
+
+#include <cstddef>
+#include <iterator>
+#include "Set.hpp"
+
+
+
+template <typename T, typename Node, unsigned int MaxHeight>
+class BinaryTreeIterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+public:
+    // Initializes an iterator that's past the end of any tree.
+    BinaryTreeIterator();
+
+    // first() returns an iterator positioned at the smallest key in the
+    // tree with the given root.
+    static BinaryTreeIterator first(const Node* root);
+
+    // lowerBound() returns an iterator positioned at the smallest key in
+    // the tree with the given root that isn't less than the given element.
+    static BinaryTreeIterator lowerBound(
+        const Node* root, typename Set<T>::KeyView element);
+
+
+    const T& operator*() const;
+    const T* operator->() const;
+
+    BinaryTreeIterator& operator++();
+    BinaryTreeIterator operator++(int);
+
+    bool operator==(const BinaryTreeIterator& other) const;
+    bool operator!=(const BinaryTreeIterator& other) const;
+
+
+private:
+    const Node* stack[MaxHeight];
+    unsigned int depth;
+
+
+private:
+    void pushLeftmost(const Node* node);
+};
+
+
+
+template <typename T, typename Node, unsigned int MaxHeight>
+BinaryTreeIterator<T, Node, MaxHeight>::BinaryTreeIterator()
+    : depth{0}
+{
+}
+
+
+template <typename T, typename Node, unsigned int MaxHeight>
+BinaryTreeIterator<T, Node, MaxHeight>
+BinaryTreeIterator<T, Node, MaxHeight>::first(const Node* root)
+{
+    BinaryTreeIterator i;
+    i.pushLeftmost(root);
+    return i;
+}
+
+
+template <typename T, typename Node, unsigned int MaxHeight>
+BinaryTreeIterator<T, Node, MaxHeight>
+BinaryTreeIterator<T, Node, MaxHeight>::lowerBound(
+    const Node* root, typename Set<T>::KeyView element)
+{
+    // Only the nodes where the search goes left are ancestors that the
+    // iterator will come back to; the last of them is the lower bound.
+    BinaryTreeIterator i;
+
+    for (const Node* node = root; node != nullptr; )
+    {
+        if (node->key < element)
+        {
+            node = node->right;
+        }
+        else
+        {
+            i.stack[i.depth++] = node;
+            node = node->left;
+        }
+    }
+
+    return i;
+}
+
+
+template <typename T, typename Node, unsigned int MaxHeight>
+const T& BinaryTreeIterator<T, Node, MaxHeight>::operator*() const
+{
+    return stack[depth - 1]->key;
+}
+
+
+template <typename T, typename Node, unsigned int MaxHeight>
+const T* BinaryTreeIterator<T, Node, MaxHeight>::operator->() const
+{
+    return &stack[depth - 1]->key;
+}
+
+
+template <typename T, typename Node, unsigned int MaxHeight>
+BinaryTreeIterator<T, Node, MaxHeight>&
+BinaryTreeIterator<T, Node, MaxHeight>::operator++()
+{
+    const Node* node = stack[--depth];
+    pushLeftmost(node->right);
+    return *this;
+}
+
+
+template <typename T, typename Node, unsigned int MaxHeight>
+BinaryTreeIterator<T, Node, MaxHeight>
+BinaryTreeIterator<T, Node, MaxHeight>::operator++(int)
+{
+    BinaryTreeIterator previous = *this;
+    ++*this;
+    return previous;
+}
+
+
+// Two iterators over the same tree that are positioned at the same node
+// have the same stack, so only the tops of the stacks need comparing.
+template <typename T, typename Node, unsigned int MaxHeight>
+bool BinaryTreeIterator<T, Node, MaxHeight>::operator==(
+    const BinaryTreeIterator& other) const
+{
+    return depth == other.depth
+        && (depth == 0 || stack[depth - 1] == other.stack[depth - 1]);
+}
+
+
+template <typename T, typename Node, unsigned int MaxHeight>
+bool BinaryTreeIterator<T, Node, MaxHeight>::operator!=(
+    const BinaryTreeIterator& other) const
+{
+    return !(*this == other);
+}
+
+
+template <typename T, typename Node, unsigned int MaxHeight>
+void BinaryTreeIterator<T, Node, MaxHeight>::pushLeftmost(const Node* node)
+{
+    for (; node != nullptr; node = node->left)
+    {
+        stack[depth++] = node;
+    }
+}
+
+
+
+#endif // BINARYTREEITERATOR_HPP
@@ -0,0 +1,370 @@
+// BloomFilterSet.hpp
+//
+// ICS 46 Spring 2017
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A BloomFilterSet wraps another Set (of any kind) and puts a Bloom filter
+// in front of it.  A Bloom filter is an array of bits in which every
+// element added to the set turns on a few bits chosen by hashing it.  If
+// any of the bits chosen for an element are off, the element was certainly
+// never added, so the wrapped set needn't be searched at all; if all of
+// them are on, the element is probably in the set, and only then is the
+// wrapped set searched to make sure.  Most of the candidate words that a
+// spell checker generates as suggestions aren't words, so most of its
+// searches end at the filter.
+//
+// The filter is "blocked": its bits are divided into 64-byte blocks, the
+// size of a typical cache line, and all of the bits chosen for an element
+// are in the same block, one in each of the block's eight 64-bit words.
+// So checking the filter reads one cache line, whose eight words can be
+// tested independently of one another.  The block and the bits are all
+// derived from a single hash of the element, by multiplying it by a
+// different odd constant for each word (the scheme used by the "split
+// block" Bloom filters in Apache Parquet).  With BITS_PER_ELEMENT bits of
+// filter for each element, about one search in a thousand for an element
+// that isn't in the set gets past the filter.
+//
+// The filter is sized for the number of elements the set has been told to
+// expect, and it's rebuilt, twice as large, whenever it fills up.  Since the
+// wrapped set can't be asked for its elements, the BloomFilterSet keeps the
+// hash of each element it adds so that it can rebuild the filter, until the
+// set is frozen; then the filter is rebuilt once more, at exactly the size
+// the elements need, and the hashes are released.  Elements added after
+// that are still added to the filter, which gradually makes it less
+// selective, but never wrong.
+//
+// A BloomFilterSet owns the set it wraps, which could be of any type, so it
+// can be moved but not copied.
+
+#ifndef BLOOMFILTERSET_HPP
+#define BLOOMFILTERSET_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include "Set.hpp"
+
+
+
+template <typename T, typename Hasher>
+class BloomFilterSet : public Set<T>
+{
+public:
+    // The number of bits of filter for each element.
+    static constexpr unsigned int BITS_PER_ELEMENT = 16;
+
+public:
+    // Initializes a BloomFilterSet that wraps the given set, so that it will
+    // use the given hasher whenever it needs to hash an element.  Any
+    // elements already in the given set are unknown to the filter, so the
+    // given set should be empty.
+    explicit BloomFilterSet(std::unique_ptr<Set<T>> inner, Hasher hasher = Hasher{});
+
+    // Cleans up the BloomFilterSet so that it leaks no memory.
+    virtual ~BloomFilterSet();
+
+    BloomFilterSet(const BloomFilterSet& s) = delete;
+
+    // Initializes a new BloomFilterSet whose contents (including the set
+    // it wraps) are moved from an expiring one.
+    BloomFilterSet(BloomFilterSet&& s);
+
+    BloomFilterSet& operator=(const BloomFilterSet& s) = delete;
+
+    // Assigns an expiring BloomFilterSet into another.
+    BloomFilterSet& operator=(BloomFilterSet&& s);
+
+
+    // isImplemented() returns true if the wrapped set is implemented.
+    virtual bool isImplemented() const;
+
+
+    // add() adds an element to the wrapped set and to the filter.  Besides
+    // the time the wrapped set takes, this function runs in amortized
+    // constant time.
+    virtual void add(const T& element);
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  Unless the filter rules the element out, which
+    // takes constant time, the wrapped set is searched.
+    virtual bool contains(const T& element) const;
+
+
+    // containsView() is equivalent to contains(), but doesn't require the
+    // caller to build an element to look for.
+    virtual bool containsView(typename Set<T>::KeyView element) const;
+
+
+    // size() returns the number of elements in the wrapped set.
+    virtual unsigned int size() const;
+
+
+    // reserve() passes the given number of elements along to the wrapped
+    // set, and sizes the filter for that many elements.
+    virtual void reserve(unsigned int count);
+
+
+    // freeze() freezes the wrapped set, and rebuilds the filter at exactly
+    // the size its elements need.
+    virtual void freeze();
+
+
+private:
+    struct alignas(64) Block
+    {
+        std::uint64_t words[8];
+    };
+
+    std::unique_ptr<Set<T>> inner;
+    Hasher hasher;
+
+    Block* blocks;
+    std::uint32_t block_count;
+
+    // The hashes of the elements that have been added, which are kept until
+    // the set is frozen, and the number of elements the filter is sized for.
+    std::uint32_t* hashes;
+    unsigned int hash_count;
+    unsigned int hash_capacity;
+
+
+private:
+    static std::uint32_t blocksFor(unsigned int count);
+    static std::uint64_t bitOf(std::uint32_t hash, unsigned int word);
+    static std::uint32_t spread(std::uint32_t hash);
+
+    void insert(std::uint32_t hash);
+    bool mayContain(std::uint32_t hash) const;
+    void rebuild(unsigned int capacity);
+};
+
+
+
+namespace BloomFilterSetDetail
+{
+    // The odd constants by which a hash is multiplied to choose its bit in
+    // each word of a block.
+    constexpr std::uint32_t SALTS[8] = {
+        0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+        0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u };
+}
+
+
+
+template <typename T, typename Hasher>
+BloomFilterSet<T, Hasher>::BloomFilterSet(std::unique_ptr<Set<T>> inner, Hasher hasher)
+    : inner{std::move(inner)}, hasher{hasher},
+      blocks{nullptr}, block_count{0},
+      hashes{nullptr}, hash_count{0}, hash_capacity{0}
+{
+    rebuild(64);
+}
+
+
+template <typename T, typename Hasher>
+BloomFilterSet<T, Hasher>::~BloomFilterSet()
+{
+    delete[] blocks;
+    delete[] hashes;
+}
+
+
+template <typename T, typename Hasher>
+BloomFilterSet<T, Hasher>::BloomFilterSet(BloomFilterSet&& s)
+    : inner{std::move(s.inner)}, hasher{s.hasher},
+      blocks{nullptr}, block_count{0},
+      hashes{nullptr}, hash_count{0}, hash_capacity{0}
+{
+    std::swap(blocks, s.blocks);
+    std::swap(block_count, s.block_count);
+    std::swap(hashes, s.hashes);
+    std::swap(hash_count, s.hash_count);
+    std::swap(hash_capacity, s.hash_capacity);
+}
+
+
+template <typename T, typename Hasher>
+BloomFilterSet<T, Hasher>& BloomFilterSet<T, Hasher>::operator=(BloomFilterSet&& s)
+{
+    std::swap(inner, s.inner);
+    std::swap(hasher, s.hasher);
+    std::swap(blocks, s.blocks);
+    std::swap(block_count, s.block_count);
+    std::swap(hashes, s.hashes);
+    std::swap(hash_count, s.hash_count);
+    std::swap(hash_capacity, s.hash_capacity);
+    return *this;
+}
+
+
+template <typename T, typename Hasher>
+bool BloomFilterSet<T, Hasher>::isImplemented() const
+{
+    return inner->isImplemented();
+}
+
+
+template <typename T, typename Hasher>
+void BloomFilterSet<T, Hasher>::add(const T& element)
+{
+    inner->add(element);
+
+    std::uint32_t hash = spread(hasher(element));
+
+    // Once the set is frozen, the hashes are gone, and the filter can no
+    // longer be rebuilt.
+    if (hashes != nullptr)
+    {
+        if (hash_count == hash_capacity)
+        {
+            rebuild(hash_capacity * 2);
+        }
+
+        hashes[hash_count++] = hash;
+    }
+
+    insert(hash);
+}
+
+
+template <typename T, typename Hasher>
+bool BloomFilterSet<T, Hasher>::contains(const T& element) const
+{
+    return BloomFilterSet<T, Hasher>::containsView(element);
+}
+
+
+template <typename T, typename Hasher>
+bool BloomFilterSet<T, Hasher>::containsView(typename Set<T>::KeyView element) const
+{
+    return mayContain(spread(hasher(element))) && inner->containsView(element);
+}
+
+
+template <typename T, typename Hasher>
+unsigned int BloomFilterSet<T, Hasher>::size() const
+{
+    return inner->size();
+}
+
+
+template <typename T, typename Hasher>
+void BloomFilterSet<T, Hasher>::reserve(unsigned int count)
+{
+    inner->reserve(count);
+
+    if (hashes != nullptr && count > hash_capacity)
+    {
+        rebuild(count);
+    }
+}
+
+
+template <typename T, typename Hasher>
+void BloomFilterSet<T, Hasher>::freeze()
+{
+    inner->freeze();
+
+    if (hashes != nullptr)
+    {
+        rebuild(std::max(hash_count, 1u));
+
+        delete[] hashes;
+        hashes = nullptr;
+        hash_count = 0;
+        hash_capacity = 0;
+    }
+}
+
+
+template <typename T, typename Hasher>
+std::uint32_t BloomFilterSet<T, Hasher>::blocksFor(unsigned int count)
+{
+    std::uint64_t bits = static_cast<std::uint64_t>(count) * BITS_PER_ELEMENT;
+    return static_cast<std::uint32_t>(std::max<std::uint64_t>((bits + 511) / 512, 1));
+}
+
+
+// bitOf() returns the bit of the given word of a block that a hash
+// chooses: the top six bits of the hash times that word's constant.
+template <typename T, typename Hasher>
+std::uint64_t BloomFilterSet<T, Hasher>::bitOf(std::uint32_t hash, unsigned int word)
+{
+    return std::uint64_t{1} << ((hash * BloomFilterSetDetail::SALTS[word]) >> 26);
+}
+
+
+// spread() scrambles a hash (with the finalizer of MurmurHash3), so that
+// every bit of the result depends on every bit of the hash.  The block is
+// chosen by the high bits of the result and the bits within it by all of
+// them, so a weak hash can't make the two choices depend on each other.
+template <typename T, typename Hasher>
+std::uint32_t BloomFilterSet<T, Hasher>::spread(std::uint32_t hash)
+{
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+
+template <typename T, typename Hasher>
+void BloomFilterSet<T, Hasher>::insert(std::uint32_t hash)
+{
+    Block& block = blocks[(static_cast<std::uint64_t>(hash) * block_count) >> 32];
+
+    for (unsigned int word = 0; word < 8; ++word)
+    {
+        block.words[word] |= bitOf(hash, word);
+    }
+}
+
+
+// mayContain() tests all eight words of the block, rather than stopping at
+// the first bit that's off, since that's cheaper than a branch that can't
+// be predicted.
+template <typename T, typename Hasher>
+bool BloomFilterSet<T, Hasher>::mayContain(std::uint32_t hash) const
+{
+    const Block& block = blocks[(static_cast<std::uint64_t>(hash) * block_count) >> 32];
+    std::uint64_t missing = 0;
+
+    for (unsigned int word = 0; word < 8; ++word)
+    {
+        missing |= ~block.words[word] & bitOf(hash, word);
+    }
+
+    return missing == 0;
+}
+
+
+// rebuild() sizes the filter for the given number of elements and adds the
+// hashes of the elements added so far to it again.
+template <typename T, typename Hasher>
+void BloomFilterSet<T, Hasher>::rebuild(unsigned int capacity)
+{
+    std::uint32_t* newHashes = new std::uint32_t[capacity];
+    std::copy(hashes, hashes + hash_count, newHashes);
+
+    delete[] hashes;
+    hashes = newHashes;
+    hash_capacity = capacity;
+
+    delete[] blocks;
+    block_count = blocksFor(capacity);
+    blocks = new Block[block_count];
+    std::fill(blocks, blocks + block_count, Block{});
+
+    for (unsigned int i = 0; i < hash_count; ++i)
+    {
+        insert(hashes[i]);
+    }
+}
+
+
+
+#endif // BLOOMFILTERSET_HPP
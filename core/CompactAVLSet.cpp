@@ -0,0 +1,349 @@
+// CompactAVLSet.cpp
+//
+// ICS 46 Spring 2017
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include "CompactAVLSet.hpp"
+
+
+
+namespace
+{
+    // The number of characters that reserve() sets aside in the arena for
+    // each word it's told to expect.
+    constexpr std::uint32_t TYPICAL_WORD_LENGTH = 10;
+
+    constexpr std::uint32_t MAX_WORD_LENGTH = 65535;
+}
+
+
+
+CompactAVLSet::CompactAVLSet()
+    : nodes{nullptr}, node_count{0}, node_capacity{0}, root{0},
+      arena{nullptr}, arena_size{0}, arena_capacity{0}
+{
+    // Node 0 is the sentinel that stands in for a missing child.
+    resizeNodes(16);
+    nodes[0] = Node{0, 0, 0, 0, 0};
+    node_count = 1;
+}
+
+
+CompactAVLSet::~CompactAVLSet()
+{
+    delete[] nodes;
+    delete[] arena;
+}
+
+
+CompactAVLSet::CompactAVLSet(const CompactAVLSet& s)
+{
+    copyAll(s);
+}
+
+
+CompactAVLSet::CompactAVLSet(CompactAVLSet&& s)
+    : CompactAVLSet{}
+{
+    std::swap(nodes, s.nodes);
+    std::swap(node_count, s.node_count);
+    std::swap(node_capacity, s.node_capacity);
+    std::swap(root, s.root);
+    std::swap(arena, s.arena);
+    std::swap(arena_size, s.arena_size);
+    std::swap(arena_capacity, s.arena_capacity);
+}
+
+
+CompactAVLSet& CompactAVLSet::operator=(const CompactAVLSet& s)
+{
+    if (this != &s)
+    {
+        delete[] nodes;
+        delete[] arena;
+        copyAll(s);
+    }
+
+    return *this;
+}
+
+
+CompactAVLSet& CompactAVLSet::operator=(CompactAVLSet&& s)
+{
+    std::swap(nodes, s.nodes);
+    std::swap(node_count, s.node_count);
+    std::swap(node_capacity, s.node_capacity);
+    std::swap(root, s.root);
+    std::swap(arena, s.arena);
+    std::swap(arena_size, s.arena_size);
+    std::swap(arena_capacity, s.arena_capacity);
+    return *this;
+}
+
+
+bool CompactAVLSet::isImplemented() const
+{
+    return true;
+}
+
+
+void CompactAVLSet::add(const std::string& element)
+{
+    if (element.size() > MAX_WORD_LENGTH)
+    {
+        throw std::length_error{"CompactAVLSet: element is too long"};
+    }
+
+    // The path is remembered by index, rather than by pointers to the
+    // links, since adding a node may move the whole array.
+    std::uint32_t path[MAX_HEIGHT];
+    bool wentLeft[MAX_HEIGHT];
+    unsigned int depth = 0;
+
+    for (std::uint32_t node = root; node != 0; )
+    {
+        int comparison = element.compare(keyOf(node));
+
+        if (comparison == 0)
+        {
+            return;
+        }
+
+        path[depth] = node;
+        wentLeft[depth] = comparison < 0;
+        ++depth;
+
+        node = comparison < 0 ? nodes[node].left : nodes[node].right;
+    }
+
+    if (node_count == node_capacity)
+    {
+        resizeNodes(node_capacity * 2);
+    }
+
+    if (arena_capacity - arena_size < element.size())
+    {
+        resizeArena(std::max<std::uint32_t>(
+            arena_capacity * 2, arena_size + static_cast<std::uint32_t>(element.size())));
+    }
+
+    std::copy(element.begin(), element.end(), arena + arena_size);
+
+    std::uint32_t added = node_count++;
+    nodes[added] = Node{
+        arena_size, 0, 0, static_cast<std::uint16_t>(element.size()), 1};
+
+    arena_size += static_cast<std::uint32_t>(element.size());
+
+    // Walk back up the path, linking each rebalanced subtree into its
+    // parent, until a subtree's height stops changing.
+    std::uint32_t child = added;
+
+    while (depth > 0)
+    {
+        --depth;
+        std::uint32_t parent = path[depth];
+
+        if (wentLeft[depth])
+        {
+            nodes[parent].left = child;
+        }
+        else
+        {
+            nodes[parent].right = child;
+        }
+
+        std::uint8_t oldHeight = nodes[parent].height;
+        updateHeight(parent);
+        child = rebalance(parent);
+
+        if (nodes[child].height == oldHeight)
+        {
+            if (depth == 0)
+            {
+                root = child;
+            }
+            else if (wentLeft[depth - 1])
+            {
+                nodes[path[depth - 1]].left = child;
+            }
+            else
+            {
+                nodes[path[depth - 1]].right = child;
+            }
+
+            return;
+        }
+    }
+
+    root = child;
+}
+
+
+bool CompactAVLSet::contains(const std::string& element) const
+{
+    return containsView(element);
+}
+
+
+bool CompactAVLSet::containsView(std::string_view element) const
+{
+    std::uint32_t node = root;
+
+    while (node != 0)
+    {
+        int comparison = element.compare(keyOf(node));
+
+        if (comparison == 0)
+        {
+            return true;
+        }
+
+        node = comparison < 0 ? nodes[node].left : nodes[node].right;
+    }
+
+    return false;
+}
+
+
+unsigned int CompactAVLSet::size() const
+{
+    return node_count - 1;
+}
+
+
+void CompactAVLSet::reserve(unsigned int count)
+{
+    if (count + 1 > node_capacity)
+    {
+        resizeNodes(count + 1);
+    }
+
+    std::uint32_t characters = count * TYPICAL_WORD_LENGTH;
+
+    if (characters > arena_capacity)
+    {
+        resizeArena(characters);
+    }
+}
+
+
+void CompactAVLSet::freeze()
+{
+    resizeNodes(node_count);
+    resizeArena(arena_size);
+}
+
+
+std::string_view CompactAVLSet::keyOf(std::uint32_t node) const
+{
+    return std::string_view{arena + nodes[node].key, nodes[node].length};
+}
+
+
+void CompactAVLSet::updateHeight(std::uint32_t node)
+{
+    std::uint8_t left = nodes[nodes[node].left].height;
+    std::uint8_t right = nodes[nodes[node].right].height;
+    nodes[node].height = std::max(left, right) + 1;
+}
+
+
+int CompactAVLSet::balanceOf(std::uint32_t node) const
+{
+    return nodes[nodes[node].left].height - nodes[nodes[node].right].height;
+}
+
+
+std::uint32_t CompactAVLSet::rotateLeft(std::uint32_t node)
+{
+    std::uint32_t right = nodes[node].right;
+    nodes[node].right = nodes[right].left;
+    nodes[right].left = node;
+    updateHeight(node);
+    updateHeight(right);
+    return right;
+}
+
+
+std::uint32_t CompactAVLSet::rotateRight(std::uint32_t node)
+{
+    std::uint32_t left = nodes[node].left;
+    nodes[node].left = nodes[left].right;
+    nodes[left].right = node;
+    updateHeight(node);
+    updateHeight(left);
+    return left;
+}
+
+
+// rebalance() restores the AVL property at a node whose subtrees' heights
+// differ by at most two, returning the root of the rebalanced subtree.
+std::uint32_t CompactAVLSet::rebalance(std::uint32_t node)
+{
+    int balance = balanceOf(node);
+
+    if (balance > 1)
+    {
+        if (balanceOf(nodes[node].left) < 0)
+        {
+            nodes[node].left = rotateLeft(nodes[node].left);
+        }
+
+        return rotateRight(node);
+    }
+    else if (balance < -1)
+    {
+        if (balanceOf(nodes[node].right) > 0)
+        {
+            nodes[node].right = rotateRight(nodes[node].right);
+        }
+
+        return rotateLeft(node);
+    }
+    else
+    {
+        return node;
+    }
+}
+
+
+void CompactAVLSet::resizeNodes(std::uint32_t capacity)
+{
+    Node* newNodes = new Node[capacity];
+    std::copy(nodes, nodes + node_count, newNodes);
+
+    delete[] nodes;
+    nodes = newNodes;
+    node_capacity = capacity;
+}
+
+
+void CompactAVLSet::resizeArena(std::uint32_t capacity)
+{
+    char* newArena = new char[capacity];
+    std::copy(arena, arena + arena_size, newArena);
+
+    delete[] arena;
+    arena = newArena;
+    arena_capacity = capacity;
+}
+
+
+void CompactAVLSet::copyAll(const CompactAVLSet& s)
+{
+    nodes = new Node[s.node_count];
+    node_count = s.node_count;
+    node_capacity = s.node_count;
+    root = s.root;
+    std::copy(s.nodes, s.nodes + s.node_count, nodes);
+
+    arena = new char[s.arena_size];
+    arena_size = s.arena_size;
+    arena_capacity = s.arena_size;
+    std::copy(s.arena, s.arena + s.arena_size, arena);
+}
+
@@ -0,0 +1,131 @@
+// CompactAVLSet.hpp
+//
+// ICS 46 Spring 2017
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A CompactAVLSet is an AVL tree of strings, like an AVLSet<std::string>,
+// that's arranged to use as little memory as it can.  An AVLSet's node
+// holds a whole std::string and two 64-bit pointers, which is more than 48
+// bytes before counting any characters the string keeps on the heap.  A
+// CompactAVLSet's node is 16 bytes:
+//
+//   * All of the nodes live in one array, and a node refers to its children
+//     by their 32-bit indexes in that array.  Index 0 is a sentinel that
+//     stands for "no child", so a missing child has a height of zero like
+//     any other node and needs no special case.
+//
+//   * The characters of all of the words live in a second array (the
+//     "arena"), one after another, with no terminators; a node holds the
+//     32-bit offset and the length of its word's characters.
+//
+// Nodes and characters are only ever appended, so neither array has any
+// per-word overhead, and freeze() trims both to exactly the size they need.
+// A word can be at most 65,535 characters long.
+
+#ifndef COMPACTAVLSET_HPP
+#define COMPACTAVLSET_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "Set.hpp"
+
+
+
+class CompactAVLSet : public Set<std::string>
+{
+public:
+    // Initializes a CompactAVLSet to be empty.
+    CompactAVLSet();
+
+    // Cleans up the CompactAVLSet so that it leaks no memory.
+    virtual ~CompactAVLSet();
+
+    // Initializes a new CompactAVLSet to be a copy of an existing one.
+    CompactAVLSet(const CompactAVLSet& s);
+
+    // Initializes a new CompactAVLSet whose contents are moved from an
+    // expiring one.
+    CompactAVLSet(CompactAVLSet&& s);
+
+    // Assigns an existing CompactAVLSet into another.
+    CompactAVLSet& operator=(const CompactAVLSet& s);
+
+    // Assigns an expiring CompactAVLSet into another.
+    CompactAVLSet& operator=(CompactAVLSet&& s);
+
+
+    virtual bool isImplemented() const;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  This function runs in O(log n)
+    // time, plus the occasional linear-time growth of one of the arrays.
+    // It throws a std::length_error if the element is too long.
+    virtual void add(const std::string& element);
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  This function runs in O(log n) time.
+    virtual bool contains(const std::string& element) const;
+
+
+    // containsView() is equivalent to contains(), but doesn't require the
+    // caller to build an element to look for.
+    virtual bool containsView(std::string_view element) const;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const;
+
+
+    // reserve() grows the node array so that it can hold the given number
+    // of elements, and the arena so that it can hold a typical word's worth
+    // of characters for each of them.
+    virtual void reserve(unsigned int count);
+
+
+    // freeze() trims the node array and the arena to exactly the size that
+    // they need.
+    virtual void freeze();
+
+
+private:
+    // No tree with fewer than 2^32 nodes is taller than this.
+    static constexpr unsigned int MAX_HEIGHT = 64;
+
+    struct Node
+    {
+        std::uint32_t key;
+        std::uint32_t left;
+        std::uint32_t right;
+        std::uint16_t length;
+        std::uint8_t height;
+    };
+
+    Node* nodes;
+    std::uint32_t node_count;
+    std::uint32_t node_capacity;
+    std::uint32_t root;
+
+    char* arena;
+    std::uint32_t arena_size;
+    std::uint32_t arena_capacity;
+
+
+private:
+    std::string_view keyOf(std::uint32_t node) const;
+    void updateHeight(std::uint32_t node);
+    int balanceOf(std::uint32_t node) const;
+    std::uint32_t rotateLeft(std::uint32_t node);
+    std::uint32_t rotateRight(std::uint32_t node);
+    std::uint32_t rebalance(std::uint32_t node);
+
+    void resizeNodes(std::uint32_t capacity);
+    void resizeArena(std::uint32_t capacity);
+    void copyAll(const CompactAVLSet& s);
+};
+
+
+
+#endif // COMPACTAVLSET_HPP
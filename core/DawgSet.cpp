@@ -0,0 +1,549 @@
+// DawgSet.cpp
+//
+// ICS 46 Spring 2017
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <algorithm>
+#include <utility>
+#include "DawgSet.hpp"
+
+
+
+namespace
+{
+    // The number of slots the register starts with; it's kept at most half
+    // full, doubling as necessary.
+    constexpr std::uint32_t INITIAL_REGISTRY_CAPACITY = 1024;
+
+    // An empty slot in the register.  (No automaton has this many states.)
+    constexpr std::uint32_t NO_STATE = 0xFFFFFFFF;
+
+
+    // resizeArray() moves the first used elements of an array into a new
+    // array with the given capacity, replacing the old one.
+    template <typename U>
+    void resizeArray(U*& array, std::uint32_t used, std::uint32_t capacity)
+    {
+        U* newArray = new U[capacity];
+        std::move(array, array + used, newArray);
+
+        delete[] array;
+        array = newArray;
+    }
+
+
+    // growth() returns the capacity that an array that's full should grow
+    // to.
+    std::uint32_t growth(std::uint32_t capacity)
+    {
+        return capacity == 0 ? 16 : capacity * 2;
+    }
+}
+
+
+
+DawgSet::DawgSet()
+    : states{nullptr}, state_count{0}, state_capacity{0},
+      labels{nullptr}, targets{nullptr}, transition_count{0}, transition_capacity{0},
+      start{0}, word_count{0}, building{false},
+      path{nullptr}, path_depth{0}, path_capacity{0},
+      open_labels{nullptr}, open_targets{nullptr}, open_size{0}, open_capacity{0},
+      registry{nullptr}, registry_capacity{0},
+      pending{nullptr}, pending_size{0}, pending_capacity{0}
+{
+    startBuilding();
+}
+
+
+DawgSet::~DawgSet()
+{
+    destroyAll();
+}
+
+
+DawgSet::DawgSet(const DawgSet& s)
+    : DawgSet{}
+{
+    releaseBuilding();
+    copyAll(s);
+}
+
+
+DawgSet::DawgSet(DawgSet&& s)
+    : DawgSet{}
+{
+    swapAll(s);
+}
+
+
+DawgSet& DawgSet::operator=(const DawgSet& s)
+{
+    if (this != &s)
+    {
+        destroyAll();
+        copyAll(s);
+    }
+
+    return *this;
+}
+
+
+DawgSet& DawgSet::operator=(DawgSet&& s)
+{
+    swapAll(s);
+    return *this;
+}
+
+
+bool DawgSet::isImplemented() const
+{
+    return true;
+}
+
+
+void DawgSet::add(const std::string& element)
+{
+    if (building && (word_count == 0 || previous < element))
+    {
+        append(element);
+        return;
+    }
+    else if (building && previous == element)
+    {
+        return;
+    }
+
+    if (pending_size == pending_capacity)
+    {
+        pending_capacity = growth(pending_capacity);
+        resizeArray(pending, pending_size, pending_capacity);
+    }
+
+    pending[pending_size++] = element;
+}
+
+
+bool DawgSet::contains(const std::string& element) const
+{
+    return containsView(element);
+}
+
+
+bool DawgSet::containsView(std::string_view element) const
+{
+    if (building || pending_size != 0)
+    {
+        finish();
+    }
+
+    std::uint32_t state = start;
+
+    for (char c : element)
+    {
+        const unsigned char* first = labels + states[state].first;
+        const unsigned char* last = first + states[state].count;
+        const unsigned char* found = std::find(first, last, static_cast<unsigned char>(c));
+
+        if (found == last)
+        {
+            return false;
+        }
+
+        state = targets[found - labels];
+    }
+
+    return states[state].final;
+}
+
+
+unsigned int DawgSet::size() const
+{
+    if (pending_size != 0)
+    {
+        finish();
+    }
+
+    return word_count;
+}
+
+
+void DawgSet::freeze()
+{
+    if (building || pending_size != 0)
+    {
+        finish();
+    }
+}
+
+
+// startBuilding() empties the automaton and prepares to build it again,
+// with only an unfinished start state on the path.
+void DawgSet::startBuilding() const
+{
+    state_count = 0;
+    transition_count = 0;
+    word_count = 0;
+
+    building = true;
+    previous.clear();
+
+    if (path_capacity == 0)
+    {
+        path_capacity = growth(path_capacity);
+        resizeArray(path, 0, path_capacity);
+    }
+
+    path[0] = OpenState{0, false};
+    path_depth = 0;
+    open_size = 0;
+
+    delete[] registry;
+    registry = new std::uint32_t[INITIAL_REGISTRY_CAPACITY];
+    registry_capacity = INITIAL_REGISTRY_CAPACITY;
+    std::fill(registry, registry + registry_capacity, NO_STATE);
+}
+
+
+// append() adds an element larger than any other in the automaton, which
+// must still be being built.  The states on the previous word's path below
+// the prefix the two share are finished, and a new state is added to the
+// path for each remaining character of the element.
+void DawgSet::append(std::string_view element) const
+{
+    std::uint32_t shared = 0;
+
+    while (shared < previous.size() && shared < element.size()
+        && previous[shared] == element[shared])
+    {
+        ++shared;
+    }
+
+    closePath(shared);
+
+    for (std::uint32_t i = shared; i < element.size(); ++i)
+    {
+        if (open_size == open_capacity)
+        {
+            std::uint32_t capacity = growth(open_capacity);
+            resizeArray(open_labels, open_size, capacity);
+            resizeArray(open_targets, open_size, capacity);
+            open_capacity = capacity;
+        }
+
+        open_labels[open_size] = static_cast<unsigned char>(element[i]);
+        open_targets[open_size] = NO_STATE;
+        ++open_size;
+
+        if (path_depth + 1 == path_capacity)
+        {
+            std::uint32_t capacity = growth(path_capacity);
+            resizeArray(path, path_depth + 1, capacity);
+            path_capacity = capacity;
+        }
+
+        path[++path_depth] = OpenState{open_size, false};
+    }
+
+    path[path_depth].final = true;
+    previous.assign(element);
+    ++word_count;
+}
+
+
+// closePath() finishes the states on the path deeper than the given depth,
+// from the bottom up, so that each one's transitions all lead to finished
+// states by the time it's finished.
+void DawgSet::closePath(std::uint32_t depth) const
+{
+    while (path_depth > depth)
+    {
+        const OpenState& state = path[path_depth];
+
+        std::uint32_t finished = registerState(
+            open_labels + state.first, open_targets + state.first,
+            open_size - state.first, state.final);
+
+        open_size = state.first;
+        --path_depth;
+
+        // The parent's last transition is the one that led here.
+        open_targets[open_size - 1] = finished;
+    }
+}
+
+
+// finish() rebuilds the automaton if there are pending elements, and
+// otherwise finishes the states remaining on the path, including the start
+// state, and releases everything that was needed only for building.
+void DawgSet::finish() const
+{
+    if (pending_size != 0)
+    {
+        rebuild();
+    }
+
+    if (!building)
+    {
+        return;
+    }
+
+    closePath(0);
+    start = registerState(open_labels, open_targets, open_size, path[0].final);
+
+    releaseBuilding();
+
+    resizeArray(states, state_count, state_count);
+    state_capacity = state_count;
+
+    resizeArray(labels, transition_count, transition_count);
+    resizeArray(targets, transition_count, transition_count);
+    transition_capacity = transition_count;
+}
+
+
+// rebuild() reads the words already in the automaton back out, in order,
+// merges them with the sorted pending elements (discarding duplicates),
+// and builds the automaton again from the result.
+void DawgSet::rebuild() const
+{
+    if (building)
+    {
+        closePath(0);
+        start = registerState(open_labels, open_targets, open_size, path[0].final);
+    }
+
+    std::string* words = new std::string[word_count + pending_size];
+    unsigned int count = 0;
+    std::string prefix;
+
+    collect(start, prefix, words, count);
+
+    std::sort(pending, pending + pending_size);
+    std::string* end = std::move(pending, pending + pending_size, words + count);
+    std::inplace_merge(words, words + count, end);
+    end = std::unique(words, end);
+
+    delete[] pending;
+    pending = nullptr;
+    pending_size = 0;
+    pending_capacity = 0;
+
+    startBuilding();
+
+    for (std::string* word = words; word != end; ++word)
+    {
+        append(*word);
+    }
+
+    delete[] words;
+}
+
+
+// collect() stores every word accepted from the given state into an
+// array, in ascending order, each one preceded by the given prefix.
+void DawgSet::collect(
+    std::uint32_t state, std::string& prefix, std::string* words, unsigned int& count) const
+{
+    if (states[state].final)
+    {
+        words[count++] = prefix;
+    }
+
+    std::uint32_t first = states[state].first;
+
+    for (std::uint32_t i = first; i < first + states[state].count; ++i)
+    {
+        prefix.push_back(static_cast<char>(labels[i]));
+        collect(targets[i], prefix, words, count);
+        prefix.pop_back();
+    }
+}
+
+
+// registerState() returns a finished state with the given transitions and
+// finality: an equivalent state from the register if there is one, or
+// else a new state, which is added to the register.
+std::uint32_t DawgSet::registerState(
+    const unsigned char* stateLabels, const std::uint32_t* stateTargets,
+    std::uint32_t count, bool final) const
+{
+    std::uint32_t mask = registry_capacity - 1;
+    std::uint32_t slot = hashState(stateLabels, stateTargets, count, final) & mask;
+
+    for (; registry[slot] != NO_STATE; slot = (slot + 1) & mask)
+    {
+        const State& candidate = states[registry[slot]];
+
+        if (candidate.count == count && candidate.final == final
+            && std::equal(stateLabels, stateLabels + count, labels + candidate.first)
+            && std::equal(stateTargets, stateTargets + count, targets + candidate.first))
+        {
+            return registry[slot];
+        }
+    }
+
+    if (state_count == state_capacity)
+    {
+        std::uint32_t capacity = growth(state_capacity);
+        resizeArray(states, state_count, capacity);
+        state_capacity = capacity;
+    }
+
+    while (transition_capacity - transition_count < count)
+    {
+        std::uint32_t capacity = growth(transition_capacity);
+        resizeArray(labels, transition_count, capacity);
+        resizeArray(targets, transition_count, capacity);
+        transition_capacity = capacity;
+    }
+
+    std::copy(stateLabels, stateLabels + count, labels + transition_count);
+    std::copy(stateTargets, stateTargets + count, targets + transition_count);
+
+    std::uint32_t added = state_count++;
+    states[added] = State{transition_count, static_cast<std::uint16_t>(count), final};
+    transition_count += count;
+
+    registry[slot] = added;
+
+    if (2 * state_count > registry_capacity)
+    {
+        growRegistry();
+    }
+
+    return added;
+}
+
+
+// hashState() combines a state's finality and transitions with FNV-1a.
+std::uint32_t DawgSet::hashState(
+    const unsigned char* stateLabels, const std::uint32_t* stateTargets,
+    std::uint32_t count, bool final) const
+{
+    std::uint32_t hash = 2166136261u ^ (final ? 1 : 0);
+
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        hash = (hash ^ stateLabels[i]) * 16777619u;
+        hash = (hash ^ stateTargets[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+
+// growRegistry() doubles the size of the register, adding every finished
+// state to it again.
+void DawgSet::growRegistry() const
+{
+    delete[] registry;
+    registry_capacity *= 2;
+    registry = new std::uint32_t[registry_capacity];
+    std::fill(registry, registry + registry_capacity, NO_STATE);
+
+    std::uint32_t mask = registry_capacity - 1;
+
+    for (std::uint32_t state = 0; state < state_count; ++state)
+    {
+        const State& s = states[state];
+        std::uint32_t slot = hashState(labels + s.first, targets + s.first, s.count, s.final) & mask;
+
+        while (registry[slot] != NO_STATE)
+        {
+            slot = (slot + 1) & mask;
+        }
+
+        registry[slot] = state;
+    }
+}
+
+
+void DawgSet::releaseBuilding() const
+{
+    building = false;
+    previous.clear();
+    previous.shrink_to_fit();
+
+    delete[] path;
+    path = nullptr;
+    path_depth = 0;
+    path_capacity = 0;
+
+    delete[] open_labels;
+    delete[] open_targets;
+    open_labels = nullptr;
+    open_targets = nullptr;
+    open_size = 0;
+    open_capacity = 0;
+
+    delete[] registry;
+    registry = nullptr;
+    registry_capacity = 0;
+}
+
+
+void DawgSet::destroyAll()
+{
+    releaseBuilding();
+
+    delete[] states;
+    delete[] labels;
+    delete[] targets;
+    delete[] pending;
+}
+
+
+// copyAll() copies only the finished automaton, so the existing set is
+// finished first.
+void DawgSet::copyAll(const DawgSet& s)
+{
+    s.finish();
+
+    states = new State[s.state_count];
+    state_count = s.state_count;
+    state_capacity = s.state_count;
+    std::copy(s.states, s.states + s.state_count, states);
+
+    labels = new unsigned char[s.transition_count];
+    targets = new std::uint32_t[s.transition_count];
+    transition_count = s.transition_count;
+    transition_capacity = s.transition_count;
+    std::copy(s.labels, s.labels + s.transition_count, labels);
+    std::copy(s.targets, s.targets + s.transition_count, targets);
+
+    start = s.start;
+    word_count = s.word_count;
+
+    pending = nullptr;
+    pending_size = 0;
+    pending_capacity = 0;
+}
+
+
+void DawgSet::swapAll(DawgSet& s)
+{
+    std::swap(states, s.states);
+    std::swap(state_count, s.state_count);
+    std::swap(state_capacity, s.state_capacity);
+    std::swap(labels, s.labels);
+    std::swap(targets, s.targets);
+    std::swap(transition_count, s.transition_count);
+    std::swap(transition_capacity, s.transition_capacity);
+    std::swap(start, s.start);
+    std::swap(word_count, s.word_count);
+    std::swap(building, s.building);
+    std::swap(previous, s.previous);
+    std::swap(path, s.path);
+    std::swap(path_depth, s.path_depth);
+    std::swap(path_capacity, s.path_capacity);
+    std::swap(open_labels, s.open_labels);
+    std::swap(open_targets, s.open_targets);
+    std::swap(open_size, s.open_size);
+    std::swap(open_capacity, s.open_capacity);
+    std::swap(registry, s.registry);
+    std::swap(registry_capacity, s.registry_capacity);
+    std::swap(pending, s.pending);
+    std::swap(pending_size, s.pending_size);
+    std::swap(pending_capacity, s.pending_capacity);
+}
+
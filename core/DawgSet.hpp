@@ -0,0 +1,191 @@
+// DawgSet.hpp
+//
+// ICS 46 Spring 2017
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A DawgSet is a set of strings stored as a minimal acyclic deterministic
+// finite automaton, sometimes called a DAWG ("directed acyclic word
+// graph").  Like a trie, it has a transition for each character, and a
+// word is in the set if following the transitions for its characters from
+// the start state leads to a final state.  Unlike a trie, any two states
+// that accept the same set of suffixes are merged into one, so the
+// automaton shares common suffixes ("-ING", "-TION", "-NESS") as well as
+// common prefixes.  A dictionary of a natural language typically needs
+// only a small fraction of the states that a trie of the same words would.
+//
+// The automaton is built with Daciuk's incremental algorithm for sorted
+// input, which never builds the unminimized trie.  Since each word is
+// larger than the one before it, only the states along the path of the
+// most recently added word can still change; every other state is already
+// in its final form.  When a word is added, the states along the previous
+// word's path below the prefix the two share can no longer change either,
+// so each of them is replaced by an equivalent state that's already in the
+// automaton, if there is one, or else added to the "register" of finished
+// states, which is an open-addressing hash table keyed by each state's
+// finality and transitions.
+//
+// Finished states are stored compactly: each state is a range of entries
+// in a pair of arrays holding the characters and target states of all of
+// the transitions, which are added in blocks as states are finished.  Once
+// the set is frozen (or first searched), the last word's path is finished
+// too, the register is discarded, and the arrays are trimmed, leaving five
+// bytes per transition and eight per state.
+//
+// Elements that arrive out of order, or after the automaton has been
+// finished, are collected in a separate buffer.  The next time the set is
+// searched (or frozen), the words already in the automaton are read back
+// out in order, merged with the sorted buffer, and the automaton is built
+// again from scratch.  So a DawgSet is meant to be loaded from sorted input
+// and then only searched, which is how a dictionary is used.
+
+#ifndef DAWGSET_HPP
+#define DAWGSET_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "Set.hpp"
+
+
+
+class DawgSet : public Set<std::string>
+{
+public:
+    // Initializes a DawgSet to be empty.
+    DawgSet();
+
+    // Cleans up the DawgSet so that it leaks no memory.
+    virtual ~DawgSet();
+
+    // Initializes a new DawgSet to be a copy of an existing one.  The
+    // existing one is finished first, if necessary.
+    DawgSet(const DawgSet& s);
+
+    // Initializes a new DawgSet whose contents are moved from an
+    // expiring one.
+    DawgSet(DawgSet&& s);
+
+    // Assigns an existing DawgSet into another.
+    DawgSet& operator=(const DawgSet& s);
+
+    // Assigns an expiring DawgSet into another.
+    DawgSet& operator=(DawgSet&& s);
+
+
+    virtual bool isImplemented() const;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  Adding an element larger than any
+    // other takes amortized time proportional to its length; any other
+    // element is buffered in amortized constant time, and the next search
+    // pays for rebuilding the automaton.
+    virtual void add(const std::string& element);
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  This function runs in time proportional to the
+    // length of the element, once the automaton is finished; the first
+    // search after adding elements finishes it first.
+    virtual bool contains(const std::string& element) const;
+
+
+    // containsView() is equivalent to contains(), but doesn't require the
+    // caller to build an element to look for.
+    virtual bool containsView(std::string_view element) const;
+
+
+    // size() returns the number of elements in the set.  Since duplicates
+    // among out-of-order elements are only discarded when the automaton is
+    // rebuilt, this function rebuilds it first, if necessary.
+    virtual unsigned int size() const;
+
+
+    // freeze() finishes the automaton, discarding everything that was
+    // needed only to build it.
+    virtual void freeze();
+
+
+private:
+    struct State
+    {
+        std::uint32_t first;
+        std::uint16_t count;
+        bool final;
+    };
+
+    // A state on the path of the most recently added word, whose
+    // transitions are the entries of open_labels and open_targets from
+    // first up to where the next state's begin.  Its last transition leads
+    // to the next state on the path, so that transition's target isn't
+    // set until the next state is finished.
+    struct OpenState
+    {
+        std::uint32_t first;
+        bool final;
+    };
+
+    // The finished states and their transitions.
+    mutable State* states;
+    mutable std::uint32_t state_count;
+    mutable std::uint32_t state_capacity;
+
+    mutable unsigned char* labels;
+    mutable std::uint32_t* targets;
+    mutable std::uint32_t transition_count;
+    mutable std::uint32_t transition_capacity;
+
+    mutable std::uint32_t start;
+    mutable unsigned int word_count;
+
+    // While building is true, the automaton isn't finished: path holds the
+    // states along the previous word's path, which aren't finished yet,
+    // and registry is the register of finished states.
+    mutable bool building;
+    mutable std::string previous;
+
+    mutable OpenState* path;
+    mutable std::uint32_t path_depth;
+    mutable std::uint32_t path_capacity;
+
+    mutable unsigned char* open_labels;
+    mutable std::uint32_t* open_targets;
+    mutable std::uint32_t open_size;
+    mutable std::uint32_t open_capacity;
+
+    mutable std::uint32_t* registry;
+    mutable std::uint32_t registry_capacity;
+
+    // Elements added out of order, waiting for the automaton to be
+    // rebuilt.
+    mutable std::string* pending;
+    mutable unsigned int pending_size;
+    mutable unsigned int pending_capacity;
+
+
+private:
+    void startBuilding() const;
+    void append(std::string_view element) const;
+    void closePath(std::uint32_t depth) const;
+    void finish() const;
+    void rebuild() const;
+    void collect(std::uint32_t state, std::string& prefix, std::string* words, unsigned int& count) const;
+
+    std::uint32_t registerState(
+        const unsigned char* stateLabels, const std::uint32_t* stateTargets,
+        std::uint32_t count, bool final) const;
+
+    std::uint32_t hashState(
+        const unsigned char* stateLabels, const std::uint32_t* stateTargets,
+        std::uint32_t count, bool final) const;
+
+    void growRegistry() const;
+    void releaseBuilding() const;
+    void destroyAll();
+    void copyAll(const DawgSet& s);
+    void swapAll(DawgSet& s);
+};
+
+
+
+#endif // DAWGSET_HPP
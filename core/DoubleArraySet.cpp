@@ -0,0 +1,427 @@
+// DoubleArraySet.cpp
+//
+// ICS 46 Spring 2017
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <algorithm>
+#include <utility>
+#include "DoubleArraySet.hpp"
+
+
+
+namespace
+{
+    // The number of codes: one for each byte, and the terminator.
+    constexpr std::uint32_t ALPHABET_SIZE = 257;
+
+    // The CHECK entry of a cell that's free, and of the cells that aren't
+    // free but have no parent (the root, and cell 0, which is never used).
+    // State numbers start at 1, so neither is ever a parent.
+    constexpr std::uint32_t FREE = 0;
+    constexpr std::uint32_t NO_PARENT = 0xFFFFFFFF;
+
+    constexpr std::uint32_t ROOT = 1;
+
+
+    // codeAt() returns the code of the transition that a word makes from
+    // the state at the given depth: the code of its character there, or
+    // the terminator if the word ends there.
+    std::uint32_t codeAt(const std::string& word, std::uint32_t depth)
+    {
+        return depth < word.size() ? static_cast<unsigned char>(word[depth]) + 1 : 0;
+    }
+}
+
+
+
+DoubleArraySet::DoubleArraySet()
+    : base{nullptr}, check{nullptr}, cell_count{0}, word_count{0},
+      pending{nullptr}, pending_size{0}, pending_capacity{0},
+      siblings{nullptr}, sibling_count{0}, sibling_capacity{0},
+      next_free{0}, largest_base{0}
+{
+    build(nullptr, 0);
+}
+
+
+DoubleArraySet::~DoubleArraySet()
+{
+    delete[] base;
+    delete[] check;
+    delete[] pending;
+}
+
+
+DoubleArraySet::DoubleArraySet(const DoubleArraySet& s)
+    : DoubleArraySet{}
+{
+    copyAll(s);
+}
+
+
+DoubleArraySet::DoubleArraySet(DoubleArraySet&& s)
+    : DoubleArraySet{}
+{
+    swapAll(s);
+}
+
+
+DoubleArraySet& DoubleArraySet::operator=(const DoubleArraySet& s)
+{
+    if (this != &s)
+    {
+        copyAll(s);
+    }
+
+    return *this;
+}
+
+
+DoubleArraySet& DoubleArraySet::operator=(DoubleArraySet&& s)
+{
+    swapAll(s);
+    return *this;
+}
+
+
+bool DoubleArraySet::isImplemented() const
+{
+    return true;
+}
+
+
+void DoubleArraySet::add(const std::string& element)
+{
+    if (pending_size == pending_capacity)
+    {
+        reserve(pending_capacity == 0 ? 16 : pending_capacity * 2);
+    }
+
+    pending[pending_size++] = element;
+}
+
+
+bool DoubleArraySet::contains(const std::string& element) const
+{
+    return containsView(element);
+}
+
+
+bool DoubleArraySet::containsView(std::string_view element) const
+{
+    if (pending_size != 0)
+    {
+        rebuild();
+    }
+
+    std::uint32_t state = ROOT;
+
+    for (char c : element)
+    {
+        std::uint32_t next = base[state] + static_cast<unsigned char>(c) + 1;
+
+        if (check[next] != state)
+        {
+            return false;
+        }
+
+        state = next;
+    }
+
+    return check[base[state]] == state;
+}
+
+
+unsigned int DoubleArraySet::size() const
+{
+    if (pending_size != 0)
+    {
+        rebuild();
+    }
+
+    return word_count;
+}
+
+
+void DoubleArraySet::reserve(unsigned int count)
+{
+    if (count <= pending_capacity)
+    {
+        return;
+    }
+
+    std::string* newPending = new std::string[count];
+    std::move(pending, pending + pending_size, newPending);
+
+    delete[] pending;
+    pending = newPending;
+    pending_capacity = count;
+}
+
+
+void DoubleArraySet::freeze()
+{
+    if (pending_size != 0)
+    {
+        rebuild();
+    }
+}
+
+
+// rebuild() reads the words already in the trie back out, in order,
+// merges them with the sorted pending elements (discarding duplicates),
+// and builds the arrays again from the result.
+void DoubleArraySet::rebuild() const
+{
+    std::string* words = new std::string[word_count + pending_size];
+    unsigned int count = 0;
+    std::string prefix;
+
+    collect(ROOT, prefix, words, count);
+
+    std::sort(pending, pending + pending_size);
+    std::string* end = std::move(pending, pending + pending_size, words + count);
+    std::inplace_merge(words, words + count, end);
+    count = static_cast<unsigned int>(std::unique(words, end) - words);
+
+    delete[] pending;
+    pending = nullptr;
+    pending_size = 0;
+    pending_capacity = 0;
+
+    build(words, count);
+    delete[] words;
+}
+
+
+// build() replaces the arrays with ones holding the given words, which
+// must be sorted and distinct, and then trims them to the size they need.
+void DoubleArraySet::build(const std::string* words, unsigned int count) const
+{
+    delete[] base;
+    delete[] check;
+    base = nullptr;
+    check = nullptr;
+    cell_count = 0;
+
+    resizeCells(std::max<std::uint32_t>(1024, 2 * count + ALPHABET_SIZE));
+
+    check[0] = NO_PARENT;
+    check[ROOT] = NO_PARENT;
+    next_free = ROOT + 1;
+    largest_base = ROOT;
+
+    if (count == 0)
+    {
+        base[ROOT] = ROOT;
+    }
+    else
+    {
+        place(ROOT, words, 0, count, 0);
+    }
+
+    delete[] siblings;
+    siblings = nullptr;
+    sibling_count = 0;
+    sibling_capacity = 0;
+
+    resizeCells(largest_base + ALPHABET_SIZE);
+    word_count = count;
+}
+
+
+// place() places the children of the given state, through which the words
+// from first up to last pass, and then (recursively) their children.  The
+// siblings of every state on the way down are kept on a stack at the end of
+// the siblings array, so they're referred to by their indexes there.
+void DoubleArraySet::place(
+    std::uint32_t state, const std::string* words, std::uint32_t first,
+    std::uint32_t last, std::uint32_t depth) const
+{
+    std::uint32_t bottom = sibling_count;
+
+    for (std::uint32_t i = first; i < last; ++i)
+    {
+        std::uint32_t code = codeAt(words[i], depth);
+
+        if (sibling_count > bottom && siblings[sibling_count - 1].code == code)
+        {
+            siblings[sibling_count - 1].last = i + 1;
+            continue;
+        }
+
+        if (sibling_count == sibling_capacity)
+        {
+            std::uint32_t capacity = sibling_capacity == 0 ? 64 : sibling_capacity * 2;
+            Sibling* newSiblings = new Sibling[capacity];
+            std::copy(siblings, siblings + sibling_count, newSiblings);
+
+            delete[] siblings;
+            siblings = newSiblings;
+            sibling_capacity = capacity;
+        }
+
+        siblings[sibling_count++] = Sibling{code, i, i + 1};
+    }
+
+    std::uint32_t stateBase = findBase(bottom, sibling_count - bottom);
+    base[state] = stateBase;
+
+    for (std::uint32_t i = bottom; i < sibling_count; ++i)
+    {
+        check[stateBase + siblings[i].code] = state;
+    }
+
+    // Every child is placed before any grandchild, so that none of the
+    // grandchildren can take a child's cell.
+    for (std::uint32_t i = bottom; i < sibling_count; ++i)
+    {
+        Sibling sibling = siblings[i];
+
+        if (sibling.code != 0)
+        {
+            place(stateBase + sibling.code, words, sibling.first, sibling.last, depth + 1);
+        }
+    }
+
+    sibling_count = bottom;
+}
+
+
+// findBase() returns the smallest BASE at which every one of the given
+// siblings has a free cell, searching from next_free onward.  As in the
+// well-known "darts" implementation, next_free moves past the densely
+// occupied region at the front of the arrays, so that later searches don't
+// have to skip over it again.
+std::uint32_t DoubleArraySet::findBase(std::uint32_t first, std::uint32_t count) const
+{
+    std::uint32_t firstCode = siblings[first].code;
+    std::uint32_t start = std::max(firstCode + 1, next_free);
+    std::uint32_t occupied = 0;
+    bool seenFree = false;
+
+    for (std::uint32_t position = start; ; ++position)
+    {
+        if (position + ALPHABET_SIZE >= cell_count)
+        {
+            resizeCells(cell_count * 2);
+        }
+
+        if (check[position] != FREE)
+        {
+            ++occupied;
+            continue;
+        }
+        else if (!seenFree)
+        {
+            next_free = position;
+            seenFree = true;
+        }
+
+        std::uint32_t candidate = position - firstCode;
+        bool fits = true;
+
+        for (std::uint32_t i = first + 1; i < first + count && fits; ++i)
+        {
+            fits = check[candidate + siblings[i].code] == FREE;
+        }
+
+        if (fits)
+        {
+            if (20 * occupied >= 19 * (position - start + 1))
+            {
+                next_free = position + 1;
+            }
+
+            largest_base = std::max(largest_base, candidate);
+            return candidate;
+        }
+    }
+}
+
+
+// resizeCells() changes the number of cells in the arrays, keeping as many
+// of the existing ones as fit; any new cells are free.
+void DoubleArraySet::resizeCells(std::uint32_t count) const
+{
+    std::uint32_t* newBase = new std::uint32_t[count];
+    std::uint32_t* newCheck = new std::uint32_t[count];
+    std::uint32_t kept = std::min(count, cell_count);
+
+    std::copy(base, base + kept, newBase);
+    std::copy(check, check + kept, newCheck);
+    std::fill(newBase + kept, newBase + count, 0);
+    std::fill(newCheck + kept, newCheck + count, FREE);
+
+    delete[] base;
+    delete[] check;
+    base = newBase;
+    check = newCheck;
+    cell_count = count;
+}
+
+
+// collect() stores every word in the subtrie rooted at the given state
+// into an array, in ascending order, each one preceded by the given prefix.
+void DoubleArraySet::collect(
+    std::uint32_t state, std::string& prefix, std::string* words, unsigned int& count) const
+{
+    std::uint32_t stateBase = base[state];
+
+    if (check[stateBase] == state)
+    {
+        words[count++] = prefix;
+    }
+
+    for (std::uint32_t code = 1; code < ALPHABET_SIZE; ++code)
+    {
+        if (check[stateBase + code] == state)
+        {
+            prefix.push_back(static_cast<char>(code - 1));
+            collect(stateBase + code, prefix, words, count);
+            prefix.pop_back();
+        }
+    }
+}
+
+
+void DoubleArraySet::copyAll(const DoubleArraySet& s)
+{
+    std::uint32_t* newBase = new std::uint32_t[s.cell_count];
+    std::uint32_t* newCheck = new std::uint32_t[s.cell_count];
+    std::copy(s.base, s.base + s.cell_count, newBase);
+    std::copy(s.check, s.check + s.cell_count, newCheck);
+
+    delete[] base;
+    delete[] check;
+    base = newBase;
+    check = newCheck;
+    cell_count = s.cell_count;
+    word_count = s.word_count;
+
+    delete[] pending;
+    pending = nullptr;
+    pending_size = 0;
+    pending_capacity = 0;
+
+    if (s.pending_size != 0)
+    {
+        pending = new std::string[s.pending_size];
+        std::copy(s.pending, s.pending + s.pending_size, pending);
+        pending_size = s.pending_size;
+        pending_capacity = s.pending_size;
+    }
+}
+
+
+void DoubleArraySet::swapAll(DoubleArraySet& s)
+{
+    std::swap(base, s.base);
+    std::swap(check, s.check);
+    std::swap(cell_count, s.cell_count);
+    std::swap(word_count, s.word_count);
+    std::swap(pending, s.pending);
+    std::swap(pending_size, s.pending_size);
+    std::swap(pending_capacity, s.pending_capacity);
+}
+
@@ -0,0 +1,143 @@
+// DoubleArraySet.hpp
+//
+// ICS 46 Spring 2017
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A DoubleArraySet is a set of strings stored in a double-array trie.  A
+// trie has a state for every prefix of every word; a double-array trie
+// numbers the states so that all of their transitions can be stored in two
+// arrays, BASE and CHECK, of the same size.  The transition from state s on
+// a character with code c leads to state t = BASE[s] + c, and that
+// transition exists only if CHECK[t] == s, since each state's CHECK entry
+// holds the number of its parent.  So following a transition is two array
+// reads and a comparison, with no pointers to chase, no siblings to search
+// and no strings to compare, and looking up a word takes time that depends
+// only on its length.
+//
+// Each byte is given the code one greater than its value, and code 0 is a
+// terminator: a state's prefix is a word in the set if the state has a
+// transition on code 0.  State 1 is the root.  The arrays are built all at
+// once, from a sorted list of the words: for each state, the children are
+// placed by searching for the smallest BASE at which all of their cells are
+// free.  Cells are also kept at least one alphabet's width beyond the
+// largest BASE, so that no transition ever needs a bounds check.
+//
+// Added elements are collected, unsorted, in a separate buffer.  The first
+// time the set is searched (or frozen) after elements have been added, the
+// words already in the trie are read back out in order, merged with the
+// sorted buffer, and the arrays are built again.
+// For words made of the upper-case letters A through Z, the children of
+// most states fit in the gaps left by others, so the arrays are dense.
+
+#ifndef DOUBLEARRAYSET_HPP
+#define DOUBLEARRAYSET_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "Set.hpp"
+
+
+
+class DoubleArraySet : public Set<std::string>
+{
+public:
+    // Initializes a DoubleArraySet to be empty.
+    DoubleArraySet();
+
+    // Cleans up the DoubleArraySet so that it leaks no memory.
+    virtual ~DoubleArraySet();
+
+    // Initializes a new DoubleArraySet to be a copy of an existing one.
+    DoubleArraySet(const DoubleArraySet& s);
+
+    // Initializes a new DoubleArraySet whose contents are moved from an
+    // expiring one.
+    DoubleArraySet(DoubleArraySet&& s);
+
+    // Assigns an existing DoubleArraySet into another.
+    DoubleArraySet& operator=(const DoubleArraySet& s);
+
+    // Assigns an expiring DoubleArraySet into another.
+    DoubleArraySet& operator=(DoubleArraySet&& s);
+
+
+    virtual bool isImplemented() const;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  This function runs in amortized
+    // constant time, though the next search pays for building it in.
+    virtual void add(const std::string& element);
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  This function runs in time proportional to the
+    // length of the element, unless elements have been added since the
+    // last search, in which case it first rebuilds the arrays.
+    virtual bool contains(const std::string& element) const;
+
+
+    // containsView() is equivalent to contains(), but doesn't require the
+    // caller to build an element to look for.
+    virtual bool containsView(std::string_view element) const;
+
+
+    // size() returns the number of elements in the set.  Since duplicates
+    // are only discarded when new elements are built in, this function
+    // builds them in first, if necessary.
+    virtual unsigned int size() const;
+
+
+    // reserve() makes room in the buffer of added elements for the given
+    // number of elements.
+    virtual void reserve(unsigned int count);
+
+
+    // freeze() builds any newly added elements into the arrays.
+    virtual void freeze();
+
+
+private:
+    // A sibling is one of the children of a state that's being placed: the
+    // code of the transition leading to it, and the range of the sorted
+    // words that pass through it.
+    struct Sibling
+    {
+        std::uint32_t code;
+        std::uint32_t first;
+        std::uint32_t last;
+    };
+
+    mutable std::uint32_t* base;
+    mutable std::uint32_t* check;
+    mutable std::uint32_t cell_count;
+    mutable unsigned int word_count;
+
+    mutable std::string* pending;
+    mutable unsigned int pending_size;
+    mutable unsigned int pending_capacity;
+
+    // These are used only while the arrays are being built.
+    mutable Sibling* siblings;
+    mutable std::uint32_t sibling_count;
+    mutable std::uint32_t sibling_capacity;
+    mutable std::uint32_t next_free;
+    mutable std::uint32_t largest_base;
+
+
+private:
+    void rebuild() const;
+    void build(const std::string* words, unsigned int count) const;
+    void place(std::uint32_t state, const std::string* words, std::uint32_t first,
+               std::uint32_t last, std::uint32_t depth) const;
+    std::uint32_t findBase(std::uint32_t first, std::uint32_t count) const;
+    void resizeCells(std::uint32_t count) const;
+    void collect(std::uint32_t state, std::string& prefix, std::string* words, unsigned int& count) const;
+    void copyAll(const DoubleArraySet& s);
+    void swapAll(DoubleArraySet& s);
+};
+
+
+
+#endif // DOUBLEARRAYSET_HPP
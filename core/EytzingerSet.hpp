@@ -0,0 +1,569 @@
+// EytzingerSet.hpp
+//
+// ICS 46 Spring 2017
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// An EytzingerSet is an implementation of a Set meant for dictionaries that
+// are mostly searched rather than changed.  Its elements are kept in one
+// array, in sorted order as a complete binary search tree would visit them
+// breadth-first (the "Eytzinger layout"): the root is at index 1, and the
+// children of the element at index k are at indexes 2k and 2k + 1.
+//
+// Unlike a binary search of a sorted array, a search of this layout always
+// moves toward the end of the array, and the elements it may visit next are
+// close together: the sixteen possible descendants four levels below index
+// k are at indexes 16k through 16k + 15.  So the search prefetches them
+// while it compares against the elements above them, and it descends by
+// computing the next index from the result of each comparison rather than
+// branching on it, which leaves no branches to mispredict.
+//
+// Added elements that aren't already in the set are kept in a separate
+// buffer, which searches look through after the tree.  The newest few
+// elements, up to TAIL_SIZE of them, are searched one by one; once there are
+// that many, they're sorted into a "run."  The buffer holds a few sorted
+// runs, each at most half as long as the one before it, and whenever a new
+// run is at least as long as the one before it, the two are merged, the way
+// a binary counter carries.  So the buffer is a handful of runs, each
+// searched by binary search, and each element is merged only O(log n)
+// times.  Once the buffer holds more elements than the tree, all of them
+// are merged with the elements in the tree and the array is rebuilt, which
+// costs O(1) per added element.  Searches never change the set, so any
+// number of threads can search it at once, as long as none is adding to
+// it.  An EytzingerSet can also be built directly from an ordered set, such
+// as an AVLSet or a BTreeSet, whose elements are already in order, so that
+// no sorting is needed.
+
+#ifndef EYTZINGERSET_HPP
+#define EYTZINGERSET_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include "Set.hpp"
+
+
+
+template <typename T>
+class EytzingerSet : public Set<T>
+{
+public:
+    // The most added elements that are searched one by one before they're
+    // sorted into the rest of the buffer.
+    static constexpr unsigned int TAIL_SIZE = 32;
+
+    // The fewest added elements that the buffer holds before it's merged
+    // into the tree.
+    static constexpr unsigned int MIN_PENDING = 256;
+
+    // The most runs the buffer can hold.  Each run is at least TAIL_SIZE
+    // elements long and at most half as long as the one before it.
+    static constexpr unsigned int MAX_RUNS = 32;
+
+public:
+    // Initializes an EytzingerSet to be empty.
+    EytzingerSet();
+
+    // Initializes an EytzingerSet holding the elements of an ordered set,
+    // which is any set with a forEachInOrder() member function that visits
+    // its elements in ascending order.  This runs in O(n) time.
+    template <typename OrderedSet>
+    explicit EytzingerSet(const OrderedSet& s);
+
+    // Cleans up the EytzingerSet so that it leaks no memory.
+    virtual ~EytzingerSet();
+
+    // Initializes a new EytzingerSet to be a copy of an existing one.
+    EytzingerSet(const EytzingerSet& s);
+
+    // Initializes a new EytzingerSet whose contents are moved from an
+    // expiring one.
+    EytzingerSet(EytzingerSet&& s);
+
+    // Assigns an existing EytzingerSet into another.
+    EytzingerSet& operator=(const EytzingerSet& s);
+
+    // Assigns an expiring EytzingerSet into another.
+    EytzingerSet& operator=(EytzingerSet&& s);
+
+
+    virtual bool isImplemented() const;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  This function runs in amortized
+    // O(log^2 n) time: it searches the set first, then occasionally merges
+    // runs in the buffer, and the buffer into the tree.
+    virtual void add(const T& element);
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  This function runs in O(log n) time once the set is
+    // frozen, and in O(log^2 n) time (plus at most TAIL_SIZE comparisons
+    // with the newest elements) while the buffer isn't empty.
+    virtual bool contains(const T& element) const;
+
+
+    // containsView() is equivalent to contains(), but doesn't require the
+    // caller to build an element to look for.
+    virtual bool containsView(typename Set<T>::KeyView element) const;
+
+
+    // size() returns the number of elements in the set.  This function
+    // always runs in constant time.
+    virtual unsigned int size() const;
+
+
+    // reserve() makes room in the buffer of added elements for the given
+    // number of elements.
+    virtual void reserve(unsigned int count);
+
+
+    // freeze() merges any elements in the buffer into the tree, so that
+    // searches needn't look through the buffer.
+    virtual void freeze();
+
+
+private:
+    // The tree is 1-indexed, so tree[0] is unused.
+    T* tree;
+    unsigned int tree_size;
+
+    // The buffer begins with its runs, one after another; run i ends where
+    // run_ends[i] says.  The elements after the last run are in the order
+    // they were added.  None of the buffer's elements are in the tree.
+    T* pending;
+    unsigned int pending_size;
+    unsigned int pending_capacity;
+    unsigned int run_ends[MAX_RUNS];
+    unsigned int run_count;
+
+
+private:
+    bool treeContains(typename Set<T>::KeyView element) const;
+    bool pendingContains(typename Set<T>::KeyView element) const;
+    static unsigned int pendingLimit(unsigned int treeSize);
+    unsigned int sortedSize() const;
+    void resizePending(unsigned int capacity);
+    void sortTail();
+    void rebuild();
+    void layOut(T* sorted, unsigned int count);
+    void fill(T* sorted, unsigned int& next, unsigned int index);
+    void collect(T* sorted, unsigned int& next, unsigned int index);
+    void copyAll(const EytzingerSet& s);
+};
+
+
+
+template <typename T>
+EytzingerSet<T>::EytzingerSet()
+    : tree{nullptr}, tree_size{0},
+      pending{nullptr}, pending_size{0}, pending_capacity{0}, run_ends{}, run_count{0}
+{
+}
+
+
+template <typename T>
+template <typename OrderedSet>
+EytzingerSet<T>::EytzingerSet(const OrderedSet& s)
+    : EytzingerSet{}
+{
+    T* sorted = new T[s.size()];
+    unsigned int count = 0;
+
+    s.forEachInOrder(
+        [&](const T& key)
+        {
+            sorted[count++] = key;
+        });
+
+    layOut(sorted, count);
+    delete[] sorted;
+}
+
+
+template <typename T>
+EytzingerSet<T>::~EytzingerSet()
+{
+    delete[] tree;
+    delete[] pending;
+}
+
+
+template <typename T>
+EytzingerSet<T>::EytzingerSet(const EytzingerSet& s)
+{
+    copyAll(s);
+}
+
+
+template <typename T>
+EytzingerSet<T>::EytzingerSet(EytzingerSet&& s)
+    : EytzingerSet{}
+{
+    std::swap(tree, s.tree);
+    std::swap(tree_size, s.tree_size);
+    std::swap(pending, s.pending);
+    std::swap(pending_size, s.pending_size);
+    std::swap(pending_capacity, s.pending_capacity);
+    std::swap(run_ends, s.run_ends);
+    std::swap(run_count, s.run_count);
+}
+
+
+template <typename T>
+EytzingerSet<T>& EytzingerSet<T>::operator=(const EytzingerSet& s)
+{
+    if (this != &s)
+    {
+        delete[] tree;
+        delete[] pending;
+        copyAll(s);
+    }
+
+    return *this;
+}
+
+
+template <typename T>
+EytzingerSet<T>& EytzingerSet<T>::operator=(EytzingerSet&& s)
+{
+    std::swap(tree, s.tree);
+    std::swap(tree_size, s.tree_size);
+    std::swap(pending, s.pending);
+    std::swap(pending_size, s.pending_size);
+    std::swap(pending_capacity, s.pending_capacity);
+    std::swap(run_ends, s.run_ends);
+    std::swap(run_count, s.run_count);
+    return *this;
+}
+
+
+template <typename T>
+bool EytzingerSet<T>::isImplemented() const
+{
+    return true;
+}
+
+
+template <typename T>
+void EytzingerSet<T>::add(const T& element)
+{
+    if (treeContains(element) || pendingContains(element))
+    {
+        return;
+    }
+
+    if (pending_size == pending_capacity)
+    {
+        resizePending(pending_capacity == 0 ? 16 : pending_capacity * 2);
+    }
+
+    pending[pending_size++] = element;
+
+    if (pending_size - sortedSize() == TAIL_SIZE)
+    {
+        sortTail();
+    }
+
+    if (pending_size > pendingLimit(tree_size))
+    {
+        rebuild();
+    }
+}
+
+
+template <typename T>
+bool EytzingerSet<T>::contains(const T& element) const
+{
+    return EytzingerSet<T>::containsView(element);
+}
+
+
+template <typename T>
+bool EytzingerSet<T>::containsView(typename Set<T>::KeyView element) const
+{
+    return treeContains(element) || pendingContains(element);
+}
+
+
+template <typename T>
+bool EytzingerSet<T>::treeContains(typename Set<T>::KeyView element) const
+{
+    unsigned int index = 1;
+
+    while (index <= tree_size)
+    {
+#if defined(__GNUC__)
+        // The sixteen descendants span more than one cache line unless the
+        // elements are small, so every line they occupy is prefetched.
+        // Near the bottom of the tree, only the ones that exist are.
+        std::size_t first = 16 * static_cast<std::size_t>(index);
+
+        if (first <= tree_size)
+        {
+            const char* descendants = reinterpret_cast<const char*>(tree + first);
+            std::size_t bytes = std::min<std::size_t>(16, tree_size + 1 - first) * sizeof(T);
+
+            for (std::size_t offset = 0; offset < bytes; offset += 64)
+            {
+                __builtin_prefetch(descendants + offset);
+            }
+        }
+#endif
+        index = 2 * index + (tree[index] < element);
+    }
+
+    // The search went right at every level after the last time it went
+    // left, at the smallest element that isn't less than the one being
+    // sought.  Shifting away those trailing right turns (and the last left
+    // turn) leaves that element's index, or zero if there wasn't one.
+#if defined(__GNUC__)
+    index >>= __builtin_ffs(~index);
+#else
+    while ((index & 1) != 0)
+    {
+        index >>= 1;
+    }
+
+    index >>= 1;
+#endif
+
+    return index != 0 && !(element < tree[index]);
+}
+
+
+template <typename T>
+bool EytzingerSet<T>::pendingContains(typename Set<T>::KeyView element) const
+{
+    unsigned int runStart = 0;
+
+    for (unsigned int run = 0; run < run_count; ++run)
+    {
+        const T* runEnd = pending + run_ends[run];
+        const T* position = std::lower_bound<const T*>(pending + runStart, runEnd, element);
+
+        if (position != runEnd && !(element < *position))
+        {
+            return true;
+        }
+
+        runStart = run_ends[run];
+    }
+
+    for (unsigned int i = runStart; i < pending_size; ++i)
+    {
+        if (!(pending[i] < element) && !(element < pending[i]))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+template <typename T>
+unsigned int EytzingerSet<T>::size() const
+{
+    return tree_size + pending_size;
+}
+
+
+template <typename T>
+void EytzingerSet<T>::reserve(unsigned int count)
+{
+    if (count > pending_capacity)
+    {
+        resizePending(count);
+    }
+}
+
+
+template <typename T>
+void EytzingerSet<T>::freeze()
+{
+    if (pending_size != 0)
+    {
+        rebuild();
+    }
+}
+
+
+// pendingLimit() returns the number of elements the buffer can hold before
+// it's merged into a tree of the given size.  Since the buffer is allowed
+// to grow as large as the tree, each rebuild at least doubles the tree, and
+// the cost of rebuilding is O(1) per added element.
+template <typename T>
+unsigned int EytzingerSet<T>::pendingLimit(unsigned int treeSize)
+{
+    return std::max(MIN_PENDING, treeSize);
+}
+
+
+template <typename T>
+unsigned int EytzingerSet<T>::sortedSize() const
+{
+    return run_count == 0 ? 0 : run_ends[run_count - 1];
+}
+
+
+template <typename T>
+void EytzingerSet<T>::resizePending(unsigned int capacity)
+{
+    T* newPending = new T[capacity];
+
+    for (unsigned int i = 0; i < pending_size; ++i)
+    {
+        newPending[i] = std::move(pending[i]);
+    }
+
+    delete[] pending;
+    pending = newPending;
+    pending_capacity = capacity;
+}
+
+
+// sortTail() sorts the newest elements into a new run, and then merges the
+// last two runs for as long as the last one is at least as long as the one
+// before it.
+template <typename T>
+void EytzingerSet<T>::sortTail()
+{
+    unsigned int sorted = sortedSize();
+
+    if (sorted == pending_size)
+    {
+        return;
+    }
+
+    std::sort(pending + sorted, pending + pending_size);
+    run_ends[run_count++] = pending_size;
+
+    while (run_count >= 2)
+    {
+        unsigned int lastStart = run_ends[run_count - 2];
+        unsigned int previousStart = run_count >= 3 ? run_ends[run_count - 3] : 0;
+
+        if (pending_size - lastStart < lastStart - previousStart)
+        {
+            break;
+        }
+
+        std::inplace_merge(pending + previousStart, pending + lastStart, pending + pending_size);
+        run_ends[run_count - 2] = pending_size;
+        --run_count;
+    }
+}
+
+
+// rebuild() merges the buffer's runs into one, merges that with the
+// elements already in the tree (which an in-order walk of the tree produces
+// in order), and lays the result out again.  The buffer's capacity is kept,
+// since it will most likely be filled again.
+template <typename T>
+void EytzingerSet<T>::rebuild()
+{
+    sortTail();
+
+    for (; run_count >= 2; --run_count)
+    {
+        unsigned int lastStart = run_ends[run_count - 2];
+        unsigned int previousStart = run_count >= 3 ? run_ends[run_count - 3] : 0;
+        std::inplace_merge(pending + previousStart, pending + lastStart, pending + pending_size);
+        run_ends[run_count - 2] = pending_size;
+    }
+
+    unsigned int count = tree_size + pending_size;
+    T* merged = new T[count];
+    unsigned int next = 0;
+
+    collect(merged, next, 1);
+    std::move(pending, pending + pending_size, merged + next);
+    std::inplace_merge(merged, merged + next, merged + count);
+    pending_size = 0;
+    run_count = 0;
+
+    layOut(merged, count);
+    delete[] merged;
+}
+
+
+template <typename T>
+void EytzingerSet<T>::layOut(T* sorted, unsigned int count)
+{
+    delete[] tree;
+    tree = new T[count + 1];
+    tree_size = count;
+
+    unsigned int next = 0;
+    fill(sorted, next, 1);
+}
+
+
+// fill() moves sorted elements into the subtree rooted at the given index,
+// by visiting it in order.
+template <typename T>
+void EytzingerSet<T>::fill(T* sorted, unsigned int& next, unsigned int index)
+{
+    if (index > tree_size)
+    {
+        return;
+    }
+
+    fill(sorted, next, 2 * index);
+    tree[index] = std::move(sorted[next++]);
+    fill(sorted, next, 2 * index + 1);
+}
+
+
+// collect() is the opposite of fill(): it moves the elements in the subtree
+// rooted at the given index out into an array, in order.
+template <typename T>
+void EytzingerSet<T>::collect(T* sorted, unsigned int& next, unsigned int index)
+{
+    if (index > tree_size)
+    {
+        return;
+    }
+
+    collect(sorted, next, 2 * index);
+    sorted[next++] = std::move(tree[index]);
+    collect(sorted, next, 2 * index + 1);
+}
+
+
+template <typename T>
+void EytzingerSet<T>::copyAll(const EytzingerSet& s)
+{
+    tree = nullptr;
+    tree_size = s.tree_size;
+    pending = nullptr;
+    pending_size = s.pending_size;
+    pending_capacity = s.pending_size;
+    std::copy(s.run_ends, s.run_ends + s.run_count, run_ends);
+    run_count = s.run_count;
+
+    if (s.tree != nullptr)
+    {
+        tree = new T[tree_size + 1];
+
+        for (unsigned int i = 1; i <= tree_size; ++i)
+        {
+            tree[i] = s.tree[i];
+        }
+    }
+
+    if (pending_size != 0)
+    {
+        pending = new T[pending_size];
+
+        for (unsigned int i = 0; i < pending_size; ++i)
+        {
+            pending[i] = s.pending[i];
+        }
+    }
+}
+
+
+
+#endif // EYTZINGERSET_HPP
@@ -0,0 +1,99 @@
+// FunctionHasher.hpp
+//
+// ICS 46 Spring 2017
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// The hash-based sets (HashSet, RobinHoodSet and SwissSet) take their
+// hash function as a "hasher" template argument: any copyable type with a
+// const call operator that accepts a Set<T>::KeyView and returns an
+// unsigned int.  When the hasher is a small type whose call operator is
+// visible at compile time (such as the ones in StringHashing.hpp), the
+// compiler can inline the hashing directly into the set's own loops.
+//
+// A hasher may also have a reseed() member function, which switches it to
+// a fresh, unpredictable hash function.  A set that notices its elements
+// piling up far more than chance would allow can call it and rehash
+// everything, which defeats inputs crafted to collide under one seed.
+// IsReseedableHasher<Hasher>::value tells whether a hasher has reseed().
+//
+// A FunctionHasher is the hasher the sets use by default.  It wraps a
+// std::function, so that any hash function chosen at run time can still
+// be used, at the cost of an indirect call every time something is hashed.
+// The function may accept either a KeyView or, like the hash functions
+// that were written before KeyViews existed, a const T&; a function of
+// the latter kind is called with a T built from the KeyView.
+
+#ifndef FUNCTIONHASHER_HPP
+#define FUNCTIONHASHER_HPP
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include "Set.hpp"
+
+
+
+template <typename Hasher, typename = void>
+struct IsReseedableHasher : std::false_type
+{
+};
+
+
+template <typename Hasher>
+struct IsReseedableHasher<Hasher, std::void_t<decltype(std::declval<Hasher&>().reseed())>>
+    : std::true_type
+{
+};
+
+
+
+template <typename T>
+class FunctionHasher
+{
+public:
+    typedef std::function<unsigned int(const T&)> HashFunction;
+
+public:
+    // Initializes a FunctionHasher that calls the given function (or
+    // anything else that std::function can wrap).
+    template <typename Function>
+    FunctionHasher(Function hashFunction);
+
+    unsigned int operator()(typename Set<T>::KeyView element) const;
+
+private:
+    typedef std::function<unsigned int(typename Set<T>::KeyView)> ViewFunction;
+
+    ViewFunction hashFunction;
+};
+
+
+
+template <typename T>
+template <typename Function>
+FunctionHasher<T>::FunctionHasher(Function hashFunction)
+{
+    if constexpr(std::is_invocable_r_v<unsigned int, const Function&, typename Set<T>::KeyView>)
+    {
+        this->hashFunction = hashFunction;
+    }
+    else
+    {
+        this->hashFunction =
+            [hashFunction](typename Set<T>::KeyView element)
+            {
+                return hashFunction(T{element});
+            };
+    }
+}
+
+
+template <typename T>
+unsigned int FunctionHasher<T>::operator()(typename Set<T>::KeyView element) const
+{
+    return hashFunction(element);
+}
+
+
+
+#endif // FUNCTIONHASHER_HPP
@@ -14,6 +14,20 @@
 // elements as there are array cells), the HashSet should be resized so
 // that it is twice as large as it was before.
 //
+// A HashSet can optionally be put into "incremental rehashing" mode, in
+// which a resize doesn't move every element at once.  Instead, the old
+// array is kept alongside the new one, and every subsequent call to add()
+// or contains() migrates at most MIGRATION_STEP buckets from the old array
+// into the new one.  Until the migration is finished, lookups check both
+// arrays.  This trades a little extra work per operation for the absence
+// of any single operation that takes linear time.
+//
+// If the hasher can be reseeded (see FunctionHasher.hpp), the HashSet also
+// watches for chains that grow past MAX_CHAIN_LENGTH.  With a load factor
+// of at most 0.8 and a reasonable hash function, that essentially never
+// happens by chance, so when it does, the HashSet assumes that its input
+// was chosen to collide, reseeds the hasher and rehashes every element.
+//
 // You are not permitted to use the containers in the C++ Standard Library
 // (such as std::vector, std::list, or std::array).  Instead, you'll need
 // to use a dynamically-allocated array and your own linked list
@@ -24,9 +38,11 @@
 #define HASHSET_HPP
 
 #include <functional>
+#include "FunctionHasher.hpp"
+#include "NodePool.hpp"
 #include "Set.hpp"
 
-template <typename T>
+template <typename T, typename Hasher = FunctionHasher<T>>
 class HashSet : public Set<T>
 {
 public:
@@ -34,13 +50,29 @@ public:
     // added to it.
     static constexpr unsigned int DEFAULT_CAPACITY = 10;
 
+    // The number of buckets migrated from the old array into the new one
+    // by each add() or contains() while an incremental rehash is underway.
+    // Because the array doubles and the next resize is due only after
+    // another 0.8 * capacity elements are added, any value of 2 or more
+    // guarantees that a migration finishes before the next one starts.
+    static constexpr int MIGRATION_STEP = 4;
+
+    // The chain length at which a HashSet with a reseedable hasher decides
+    // that its elements are colliding deliberately, and the number of
+    // times it will reseed before concluding that reseeding doesn't help.
+    static constexpr int MAX_CHAIN_LENGTH = 16;
+    static constexpr int MAX_RESEEDS = 8;
+
     // A HashFunction 
-    typedef std::function<unsigned int(const T&)> HashFunction;
+    typedef typename FunctionHasher<T>::HashFunction HashFunction;
 
 public:
     // Initializes a HashSet to be empty, so that it will use the given
-    // hash function whenever it needs to hash an element.
-    HashSet(HashFunction hashFunction);
+    // hasher whenever it needs to hash an element.  (With the default
+    // Hasher, this can be any hash function.)  When incremental is true,
+    // resizes are spread out over subsequent operations rather than being
+    // done all at once.
+    HashSet(Hasher hashFunction = Hasher{}, bool incremental = false);
 
     // Cleans up the HashSet so that it leaks no memory.
     virtual ~HashSet();
@@ -70,7 +102,7 @@ public:
     // where the array is resized, this function runs in linear time (with
     // respect to the number of elements, assuming a good hash function);
     // otherwise, it runs in constant time (again, assuming a good hash
-    // function).
+    // function).  In incremental mode, it always runs in constant time.
     virtual void add(const T& element);
 
 
@@ -80,221 +112,380 @@ public:
     virtual bool contains(const T& element) const;
 
 
+    // containsView() is equivalent to contains(), but doesn't require the
+    // caller to build an element to look for.
+    virtual bool containsView(typename Set<T>::KeyView element) const;
+
+
     // size() returns the number of elements in the set.
     virtual unsigned int size() const;
 
 
+    // reserve() resizes the array, if necessary, so that the given number
+    // of elements can be added without the ratio of size to capacity
+    // exceeding 0.8.  This function runs in linear time when the array is
+    // resized and in constant time otherwise.
+    virtual void reserve(unsigned int count);
+
+
 private:
-    HashFunction hashFunction;
+    Hasher hashFunction;
+
+    // Each node caches the full hash code of its key, so that resizing
+    // never needs to call hashFunction again and lookups can skip keys
+    // whose hash codes differ without comparing the keys themselves.
     struct Node
     {
         T key; 
+        unsigned int code=0;
         Node* next=nullptr; 
     };
-    Node** hash; 
+    NodePool<Node> pool;
+    bool incremental;
+
+    // While an incremental rehash is underway, old_hash holds the array
+    // being drained and old_index is the first of its buckets that hasn't
+    // been migrated yet; otherwise, old_hash is nullptr.  These (and the
+    // new array) are mutable because contains() helps with the migration.
+    mutable Node** hash; 
+    mutable Node** old_hash=nullptr;
     int hash_size; 
     int hash_capacity; 
+    int old_capacity=0;
+    mutable int old_index=0;
+    int reseeds=0;
     void deleteall();
-    void deletenode(Node* L);
-    void resize(Node** hash);
-    void insert(Node** Hash, const T& element);
+    void resize(int capacity);
+    void migrate(int buckets) const;
+    int chainLength(unsigned int code) const;
+    void reseed();
+    bool find(typename Set<T>::KeyView element, unsigned int code) const;
+    void insert(const T& element, unsigned int code);
+    void relink(Node* node) const;
     void copyall(const HashSet& s);
-    void createnewhash(const HashSet& s);
+    void createnewhash(int capacity);
 };
 
 
-template <typename T>
-HashSet<T>::HashSet(HashFunction hashFunction)
-    : hashFunction{hashFunction}, hash_size{0}, hash_capacity{DEFAULT_CAPACITY}
+template <typename T, typename Hasher>
+HashSet<T, Hasher>::HashSet(Hasher hashFunction, bool incremental)
+    : hashFunction{hashFunction}, incremental{incremental}, hash_size{0}
 {
-    hash=new Node*[hash_capacity];
-    for(int i=0; i<hash_capacity;i++)
-    {
-        hash[i]=nullptr; 
-    }
+    createnewhash(DEFAULT_CAPACITY);
 }
 
 
-template <typename T>
-HashSet<T>::~HashSet()
+template <typename T, typename Hasher>
+HashSet<T, Hasher>::~HashSet()
 {
     deleteall(); 
 }
 
 
-template <typename T>
-HashSet<T>::HashSet(const HashSet& s)
-    : hashFunction{nullptr}
+template <typename T, typename Hasher>
+HashSet<T, Hasher>::HashSet(const HashSet& s)
+    : hashFunction{s.hashFunction}, incremental{s.incremental}
 {
     copyall(s);
     hash_size=s.hash_size;
 }
 
 
-template <typename T>
-HashSet<T>::HashSet(HashSet&& s)
-    : hashFunction{nullptr}
+template <typename T, typename Hasher>
+HashSet<T, Hasher>::HashSet(HashSet&& s)
+    : hashFunction{s.hashFunction}, incremental{s.incremental}, hash_size{0}
 {  
-    createnewhash(s);
-    std::swap(hashFunction,s.hashFunction);
+    createnewhash(DEFAULT_CAPACITY);
+    pool.swap(s.pool);
     std::swap(hash,s.hash);
+    std::swap(old_hash,s.old_hash);
     std::swap(hash_size,s.hash_size);
     std::swap(hash_capacity,s.hash_capacity);
+    std::swap(old_capacity,s.old_capacity);
+    std::swap(old_index,s.old_index);
+    std::swap(reseeds,s.reseeds);
 }
 
 
-template <typename T>
-HashSet<T>& HashSet<T>::operator=(const HashSet& s)
+template <typename T, typename Hasher>
+HashSet<T, Hasher>& HashSet<T, Hasher>::operator=(const HashSet& s)
 {
-    deleteall();
-    copyall(s);
-    hash_size=s.hash_size;
+    if(this!=&s)
+    {
+        deleteall();
+        copyall(s);
+        incremental=s.incremental;
+        hash_size=s.hash_size;
+    }
     return *this;
 }
 
 
-template <typename T>
-HashSet<T>& HashSet<T>::operator=(HashSet&& s)
+template <typename T, typename Hasher>
+HashSet<T, Hasher>& HashSet<T, Hasher>::operator=(HashSet&& s)
 {
-    createnewhash(s);
     std::swap(hashFunction,s.hashFunction);
+    std::swap(incremental,s.incremental);
+    pool.swap(s.pool);
     std::swap(hash,s.hash);
+    std::swap(old_hash,s.old_hash);
     std::swap(hash_size,s.hash_size);
     std::swap(hash_capacity,s.hash_capacity);
+    std::swap(old_capacity,s.old_capacity);
+    std::swap(old_index,s.old_index);
+    std::swap(reseeds,s.reseeds);
     return *this;
 }
 
 
-template <typename T>
-bool HashSet<T>::isImplemented() const
+template <typename T, typename Hasher>
+bool HashSet<T, Hasher>::isImplemented() const
 {
     return true;
 }
 
 
-template <typename T>
-void HashSet<T>::add(const T& element)
+template <typename T, typename Hasher>
+void HashSet<T, Hasher>::add(const T& element)
 {
-    if(!contains(element))
+    migrate(MIGRATION_STEP);
+
+    unsigned int code=hashFunction(element);
+    if(find(element, code))
+    {
+        return;
+    }
+
+    insert(element, code);
+    hash_size++;
+    if(static_cast<double>(hash_size)/static_cast<double>(hash_capacity)>0.8)
     {
-        insert(hash, element);        
-        if(static_cast<double>(hash_size)/static_cast<double>(hash_capacity)>0.8)
+        resize(hash_capacity*2);
+    }
+    else if constexpr(IsReseedableHasher<Hasher>::value)
+    {
+        if(reseeds<MAX_RESEEDS && chainLength(code)>MAX_CHAIN_LENGTH)
         {
-            resize(hash);
+            reseed();
         }
     }
-    hash_size++;
 }
 
 
-template<typename T>
-void HashSet<T>:: insert(Node** Hash, const T& element)
+template <typename T, typename Hasher>
+int HashSet<T, Hasher>::chainLength(unsigned int code) const
 {
-        int index=hashFunction(element)%hash_capacity; 
-        Node* addon= new Node();
+    int length=0;
+    for(Node* temp=hash[code%hash_capacity];temp!=nullptr; temp=temp->next)
+    {
+        length++;
+    }
+    return length;
+}
+
+
+// reseed() switches the hasher to a new seed, then recomputes the hash
+// code of every element and relinks it into a fresh array of the same
+// capacity.
+template <typename T, typename Hasher>
+void HashSet<T, Hasher>::reseed()
+{
+    migrate(old_capacity);
+    hashFunction.reseed();
+    reseeds++;
+
+    Node** copy=hash;
+    createnewhash(hash_capacity);
+    for(int n=0; n<hash_capacity; n++)
+    {
+        Node* temp=copy[n];
+        while(temp!=nullptr)
+        {
+            Node* next=temp->next;
+            temp->code=hashFunction(temp->key);
+            relink(temp);
+            temp=next;
+        }
+    }
+    delete[] copy;
+}
+
+
+template <typename T, typename Hasher>
+void HashSet<T, Hasher>:: insert(const T& element, unsigned int code)
+{
+        Node* addon= pool.create();
         addon->key=element; 
-        addon->next=hash[index]; 
-        hash[index]=addon;   
+        addon->code=code;
+        relink(addon);
 }
 
 
-template <typename T>
-bool HashSet<T>::contains(const T& element) const
+template <typename T, typename Hasher>
+void HashSet<T, Hasher>:: relink(Node* node) const
+{
+        int index=node->code%hash_capacity; 
+        node->next=hash[index]; 
+        hash[index]=node;   
+}
+
+
+template <typename T, typename Hasher>
+bool HashSet<T, Hasher>::contains(const T& element) const
+{   
+    migrate(MIGRATION_STEP);
+    return find(element, hashFunction(element));
+}
+
+
+template <typename T, typename Hasher>
+bool HashSet<T, Hasher>::containsView(typename Set<T>::KeyView element) const
 {   
-    int index=hashFunction(element)%hash_capacity;
-    for(Node* temp=hash[index];temp!=nullptr; temp=temp->next)
+    migrate(MIGRATION_STEP);
+    return find(element, hashFunction(element));
+}
+
+
+template <typename T, typename Hasher>
+bool HashSet<T, Hasher>::find(typename Set<T>::KeyView element, unsigned int code) const
+{
+    for(Node* temp=hash[code%hash_capacity];temp!=nullptr; temp=temp->next)
     {
-        if(temp->key==element)
+        if(temp->code==code && temp->key==element)
         {
             return true; 
         }
     }
+    if(old_hash!=nullptr)
+    {
+        for(Node* temp=old_hash[code%old_capacity];temp!=nullptr; temp=temp->next)
+        {
+            if(temp->code==code && temp->key==element)
+            {
+                return true; 
+            }
+        }
+    }
     return false;
 }
 
 
-template <typename T>
-unsigned int HashSet<T>::size() const
+template <typename T, typename Hasher>
+unsigned int HashSet<T, Hasher>::size() const
 {
     return hash_size;
 }
 
 
-template<typename T>
-void HashSet<T>:: deleteall()
+template <typename T, typename Hasher>
+void HashSet<T, Hasher>::reserve(unsigned int count)
 {
-    for (int n=0; n<hash_capacity; n++)
+    int capacity=static_cast<int>(count/0.8)+1;
+    if(capacity>hash_capacity)
     {
-        deletenode(hash[n]);
+        bool was_incremental=incremental;
+        incremental=false;
+        resize(capacity);
+        incremental=was_incremental;
     }
-    delete hash; 
 }
 
 
-template<typename T>
-void HashSet<T>:: deletenode(Node* L)
+// Every node lives in the pool, so there's no need to walk the chains;
+// the pool releases all of them at once.
+template <typename T, typename Hasher>
+void HashSet<T, Hasher>:: deleteall()
+{
+    pool.clear();
+    delete[] hash; 
+    delete[] old_hash;
+    old_hash=nullptr;
+}
+
+
+// Because every node already knows its hash code, resizing only has to
+// move the existing nodes into the new array; no key is rehashed, copied
+// or reallocated.  In incremental mode, even that is deferred to migrate().
+template <typename T, typename Hasher>
+void HashSet<T, Hasher>:: resize(int capacity)
 {
-    if(L!=nullptr)
+    migrate(old_capacity);
+    old_hash=hash; 
+    old_capacity=hash_capacity;
+    old_index=0;
+    createnewhash(capacity);
+    if(!incremental)
     {
-        deletenode(L->next);
-        delete L; 
+        migrate(old_capacity);
     }
 }
 
 
-template<typename T>
-void HashSet<T>:: resize(Node** Hash)
+// migrate() moves up to the given number of buckets from the old array
+// into the new one, releasing the old array once it has been drained.
+template <typename T, typename Hasher>
+void HashSet<T, Hasher>:: migrate(int buckets) const
 {
-    Node**copy=hash; 
-    hash_capacity=hash_capacity*2; 
-    hash=new Node* [hash_capacity];
-    for(int i=0; i<hash_capacity;i++)
+    if(old_hash==nullptr)
     {
-        hash[i]=nullptr; 
+        return;
     }
-    for( int n=0; n<(hash_capacity/2);n++)
+    for(; buckets>0 && old_index<old_capacity; buckets--, old_index++)
     {
-        for (Node* temp=copy[n];temp!=nullptr; temp=temp->next)
+        Node* temp=old_hash[old_index];
+        while(temp!=nullptr)
         {
-            insert(hash,temp->key);
+            Node* next=temp->next;
+            relink(temp);
+            temp=next;
         }
+        old_hash[old_index]=nullptr;
     }
-    for(int j=0; j<hash_capacity/2; j++)
+    if(old_index==old_capacity)
     {
-        deletenode(copy[j]);
+        delete[] old_hash;
+        old_hash=nullptr;
     }
-    delete[] copy; 
 }
 
 
-template<typename T>
-void HashSet<T>:: copyall(const HashSet& s)
+template <typename T, typename Hasher>
+void HashSet<T, Hasher>:: copyall(const HashSet& s)
 {
     hashFunction=s.hashFunction;
-    hash= new Node*[s.hash_capacity];
+    createnewhash(s.hash_capacity);
     for( int i=0; i<s.hash_capacity;i++)
     {
-        Node* newnode=hash[i];
         for(Node* temp=s.hash[i];temp!=nullptr;temp=temp->next)
         {    
-            newnode= new Node(); 
+            Node* newnode= pool.create(); 
+            newnode->key=temp->key;
+            newnode->code=temp->code;
+            relink(newnode);
+        }
+    }
+    for( int i=0; s.old_hash!=nullptr && i<s.old_capacity;i++)
+    {
+        for(Node* temp=s.old_hash[i];temp!=nullptr;temp=temp->next)
+        {    
+            Node* newnode= pool.create(); 
             newnode->key=temp->key;
-            newnode->next=temp->next;   
-            newnode=hash[i];  
+            newnode->code=temp->code;
+            relink(newnode);
         }
     }
 }
 
 
-template<typename T>
-void HashSet<T>:: createnewhash(const HashSet& s)
+template <typename T, typename Hasher>
+void HashSet<T, Hasher>:: createnewhash(int capacity)
 {
-    hash=new Node*[s.hash_capacity];
-    for (int i=0; i<s.hash_capacity;i++)
+    hash_capacity=capacity;
+    hash=new Node*[hash_capacity];
+    for (int i=0; i<hash_capacity;i++)
     {
         hash[i]=nullptr; 
     }
 }
 
 #endif // HASHSET_HPP
-
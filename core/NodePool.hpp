@@ -0,0 +1,179 @@
+// NodePool.hpp
+//
+// ICS 46 Spring 2017
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A NodePool is an arena from which a linked data structure allocates its
+// nodes.  Rather than asking the heap for every node individually, it
+// carves nodes out of large slabs, each of which is aligned to a cache
+// line and holds SLAB_BYTES worth of nodes.  Nodes allocated one after
+// another therefore sit next to each other in memory.
+//
+// Nodes are never released individually; instead, clear() destroys every
+// node in the pool and hands the slabs back to the heap, which costs one
+// deallocation per slab rather than one per node.  (Destructors are still
+// run on every node whose type needs it, but that's a linear sweep through
+// contiguous memory rather than a traversal of the structure.)
+
+#ifndef NODEPOOL_HPP
+#define NODEPOOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+
+template <typename Node>
+class NodePool
+{
+public:
+    // The alignment of each slab, chosen to match a typical cache line.
+    static constexpr std::size_t CACHE_LINE = 64;
+
+    // The approximate number of bytes of nodes that each slab holds.
+    static constexpr std::size_t SLAB_BYTES = 64 * 1024;
+
+public:
+    // Initializes a NodePool to be empty; no slabs are allocated until
+    // the first node is created.
+    NodePool();
+
+    // Destroys every node in the pool and releases its slabs.
+    ~NodePool();
+
+    // A NodePool owns the memory of the nodes allocated from it, so it
+    // can't be copied; structures that are copied build their own nodes
+    // in their own pools instead.
+    NodePool(const NodePool& p) = delete;
+    NodePool& operator=(const NodePool& p) = delete;
+
+
+    // create() returns a pointer to a new, default-constructed node.
+    Node* create();
+
+
+    // reserve() ensures that at least the given number of nodes can be
+    // created before another slab is needed, allocating one slab large
+    // enough to hold all of them if necessary.
+    void reserve(std::size_t count);
+
+
+    // clear() destroys every node that has been created from the pool and
+    // releases all of its slabs, after which the pool is empty again.
+    void clear();
+
+
+    // swap() exchanges the contents of two pools, which is how structures
+    // that use them implement their move operations.
+    void swap(NodePool& p);
+
+
+private:
+    struct Slab
+    {
+        char* memory;
+        Node* nodes;
+        std::size_t used;
+        std::size_t capacity;
+        Slab* next;
+    };
+
+    Slab* slabs;
+
+
+private:
+    void addSlab(std::size_t capacity);
+};
+
+
+
+template <typename Node>
+NodePool<Node>::NodePool()
+    : slabs{nullptr}
+{
+}
+
+
+template <typename Node>
+NodePool<Node>::~NodePool()
+{
+    clear();
+}
+
+
+template <typename Node>
+Node* NodePool<Node>::create()
+{
+    if (slabs == nullptr || slabs->used == slabs->capacity)
+    {
+        std::size_t capacity = SLAB_BYTES / sizeof(Node);
+        addSlab(capacity > 0 ? capacity : 1);
+    }
+
+    Node* node = new (slabs->nodes + slabs->used) Node();
+    ++slabs->used;
+    return node;
+}
+
+
+template <typename Node>
+void NodePool<Node>::reserve(std::size_t count)
+{
+    if (slabs == nullptr || slabs->capacity - slabs->used < count)
+    {
+        addSlab(count);
+    }
+}
+
+
+template <typename Node>
+void NodePool<Node>::clear()
+{
+    while (slabs != nullptr)
+    {
+        Slab* slab = slabs;
+        slabs = slabs->next;
+
+        if (!std::is_trivially_destructible<Node>::value)
+        {
+            for (std::size_t i = 0; i < slab->used; ++i)
+            {
+                slab->nodes[i].~Node();
+            }
+        }
+
+        delete[] slab->memory;
+        delete slab;
+    }
+}
+
+
+template <typename Node>
+void NodePool<Node>::swap(NodePool& p)
+{
+    std::swap(slabs, p.slabs);
+}
+
+
+template <typename Node>
+void NodePool<Node>::addSlab(std::size_t capacity)
+{
+    Slab* slab = new Slab;
+    slab->memory = new char[capacity * sizeof(Node) + CACHE_LINE];
+
+    std::uintptr_t address = reinterpret_cast<std::uintptr_t>(slab->memory);
+    std::uintptr_t aligned = (address + CACHE_LINE - 1) & ~(CACHE_LINE - 1);
+
+    slab->nodes = reinterpret_cast<Node*>(aligned);
+    slab->used = 0;
+    slab->capacity = capacity;
+    slab->next = slabs;
+    slabs = slab;
+}
+
+
+
+#endif // NODEPOOL_HPP
@@ -0,0 +1,121 @@
+// OrderedRange.hpp
+//
+// ICS 46 Spring 2017
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// The sets that keep their elements in order -- AVLSet, BSTSet, BTreeSet
+// and SkipListSet -- each provide a forward iterator that visits elements
+// in ascending order, along with begin(), end(), and lowerBound(), which
+// returns an iterator positioned at the first element that isn't less than
+// a given one.  Finding that position takes O(log n) time, and moving from
+// one element to the next takes amortized constant time, so visiting the k
+// elements of a range takes O(log n + k) time.
+//
+// An OrderedRange is a pair of such iterators, which can be used directly
+// in a range-based for loop.  The sets of strings use them to answer
+// prefix queries: every string that begins with a prefix is at least as
+// large as the prefix and smaller than its "successor," the smallest string
+// that's larger than every string beginning with it.  So the strings with
+// a given prefix are found with two calls to lowerBound(), no matter how
+// many strings there are before or after them.
+
+#ifndef ORDEREDRANGE_HPP
+#define ORDEREDRANGE_HPP
+
+#include <string>
+#include <string_view>
+
+
+
+template <typename Iterator>
+class OrderedRange
+{
+public:
+    // Initializes an OrderedRange that begins at first and ends just
+    // before last.
+    OrderedRange(Iterator first, Iterator last);
+
+    Iterator begin() const;
+    Iterator end() const;
+
+    // empty() returns true if the range contains no elements.
+    bool empty() const;
+
+private:
+    Iterator first;
+    Iterator last;
+};
+
+
+
+template <typename Iterator>
+OrderedRange<Iterator>::OrderedRange(Iterator first, Iterator last)
+    : first{first}, last{last}
+{
+}
+
+
+template <typename Iterator>
+Iterator OrderedRange<Iterator>::begin() const
+{
+    return first;
+}
+
+
+template <typename Iterator>
+Iterator OrderedRange<Iterator>::end() const
+{
+    return last;
+}
+
+
+template <typename Iterator>
+bool OrderedRange<Iterator>::empty() const
+{
+    return first == last;
+}
+
+
+
+// prefixSuccessor() returns the smallest string that's larger than every
+// string beginning with the given prefix, or an empty string if there's no
+// such string (because the prefix is empty or consists entirely of bytes
+// with the largest possible value).  Strings compare their characters as
+// unsigned values, so the successor is the prefix with its trailing 0xFF
+// bytes removed and its last remaining byte incremented.
+inline std::string prefixSuccessor(std::string_view prefix)
+{
+    std::string successor{prefix};
+
+    while (!successor.empty()
+        && static_cast<unsigned char>(successor.back()) == 0xFF)
+    {
+        successor.pop_back();
+    }
+
+    if (!successor.empty())
+    {
+        successor.back() = static_cast<char>(
+            static_cast<unsigned char>(successor.back()) + 1);
+    }
+
+    return successor;
+}
+
+
+// makePrefixRange() returns the range of the elements of an ordered set of
+// strings that begin with the given prefix.
+template <typename OrderedSet>
+OrderedRange<typename OrderedSet::Iterator> makePrefixRange(
+    const OrderedSet& s, std::string_view prefix)
+{
+    std::string successor = prefixSuccessor(prefix);
+
+    return OrderedRange<typename OrderedSet::Iterator>{
+        s.lowerBound(prefix),
+        successor.empty() ? s.end() : s.lowerBound(successor)};
+}
+
+
+
+#endif // ORDEREDRANGE_HPP
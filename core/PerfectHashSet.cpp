@@ -0,0 +1,469 @@
+// PerfectHashSet.cpp
+//
+// ICS 46 Spring 2017
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include "PerfectHashSet.hpp"
+#include "StringHashing.hpp"
+
+
+
+namespace
+{
+    // A word whose hash's low 32 bits are below this threshold (60% of the
+    // way to 2^32) goes to one of the dense buckets.
+    constexpr std::uint32_t DENSE_THRESHOLD = 2576980377u;
+
+    // The number of pilots tried for a bucket before giving up and starting
+    // over with another seed, for every word in the set.  A bucket of one
+    // word that's placed when only one slot is left needs about as many
+    // tries as there are slots, so running out is practically impossible
+    // unless two words' hashes are identical.
+    constexpr std::uint64_t PILOTS_PER_WORD = 64;
+    constexpr std::uint64_t MIN_PILOTS = 65536;
+
+
+    // pilotHash() scrambles a pilot, so that the slots that consecutive
+    // pilots choose for a word have nothing to do with one another.
+    std::uint64_t pilotHash(std::uint32_t pilot)
+    {
+        using namespace StringHashingDetail;
+        return mix(pilot ^ WYHASH_SECRET[0], WYHASH_SECRET[3]);
+    }
+}
+
+
+
+PerfectHashSet::PerfectHashSet()
+    : seed{0}, pilots{nullptr}, bucket_count{0}, dense_buckets{0},
+      offsets{nullptr}, arena{nullptr}, slot_count{0},
+      pending{nullptr}, pending_size{0}, pending_capacity{0}
+{
+    offsets = new std::uint32_t[1]{0};
+}
+
+
+PerfectHashSet::~PerfectHashSet()
+{
+    delete[] pilots;
+    delete[] offsets;
+    delete[] arena;
+    delete[] pending;
+}
+
+
+PerfectHashSet::PerfectHashSet(const PerfectHashSet& s)
+    : PerfectHashSet{}
+{
+    copyAll(s);
+}
+
+
+PerfectHashSet::PerfectHashSet(PerfectHashSet&& s)
+    : PerfectHashSet{}
+{
+    swapAll(s);
+}
+
+
+PerfectHashSet& PerfectHashSet::operator=(const PerfectHashSet& s)
+{
+    if (this != &s)
+    {
+        copyAll(s);
+    }
+
+    return *this;
+}
+
+
+PerfectHashSet& PerfectHashSet::operator=(PerfectHashSet&& s)
+{
+    swapAll(s);
+    return *this;
+}
+
+
+bool PerfectHashSet::isImplemented() const
+{
+    return true;
+}
+
+
+void PerfectHashSet::add(const std::string& element)
+{
+    if (pending_size == pending_capacity)
+    {
+        reserve(pending_capacity == 0 ? 16 : pending_capacity * 2);
+    }
+
+    pending[pending_size++] = element;
+}
+
+
+bool PerfectHashSet::contains(const std::string& element) const
+{
+    return containsView(element);
+}
+
+
+bool PerfectHashSet::containsView(std::string_view element) const
+{
+    if (pending_size != 0)
+    {
+        rebuild();
+    }
+
+    if (slot_count == 0)
+    {
+        return false;
+    }
+
+    std::uint64_t hash = hashStringAsWyhash64(element, seed);
+    return wordAt(slotOf(hash, pilots[bucketOf(hash)])) == element;
+}
+
+
+unsigned int PerfectHashSet::size() const
+{
+    if (pending_size != 0)
+    {
+        rebuild();
+    }
+
+    return slot_count;
+}
+
+
+void PerfectHashSet::reserve(unsigned int count)
+{
+    if (count <= pending_capacity)
+    {
+        return;
+    }
+
+    std::string* newPending = new std::string[count];
+    std::move(pending, pending + pending_size, newPending);
+
+    delete[] pending;
+    pending = newPending;
+    pending_capacity = count;
+}
+
+
+void PerfectHashSet::freeze()
+{
+    if (pending_size != 0)
+    {
+        rebuild();
+    }
+}
+
+
+// bucketOf() returns the bucket that a hash chooses.  Its low 32 bits
+// decide whether it's one of the dense buckets or one of the sparse ones,
+// and its high 32 bits decide which one.
+std::uint32_t PerfectHashSet::bucketOf(std::uint64_t hash) const
+{
+    std::uint64_t high = hash >> 32;
+
+    if (static_cast<std::uint32_t>(hash) < DENSE_THRESHOLD)
+    {
+        return static_cast<std::uint32_t>((high * dense_buckets) >> 32);
+    }
+    else
+    {
+        return dense_buckets + static_cast<std::uint32_t>(
+            (high * (bucket_count - dense_buckets)) >> 32);
+    }
+}
+
+
+// slotOf() returns the slot that a hash chooses with the given pilot.  The
+// hash and the pilot's hash are mixed together, since the words in a bucket
+// have hashes whose high bits are alike, and the mixed result is scaled to
+// the number of slots by taking the high half of its product with it.
+std::uint32_t PerfectHashSet::slotOf(std::uint64_t hash, std::uint32_t pilot) const
+{
+    using namespace StringHashingDetail;
+
+    std::uint64_t mixed = mix(hash ^ pilotHash(pilot), WYHASH_SECRET[2]);
+    std::uint64_t slots = slot_count;
+    multiply128(mixed, slots);
+    return static_cast<std::uint32_t>(slots);
+}
+
+
+std::string_view PerfectHashSet::wordAt(std::uint32_t slot) const
+{
+    return std::string_view{arena + offsets[slot], offsets[slot + 1] - offsets[slot]};
+}
+
+
+// rebuild() gathers the words already in the table together with the
+// pending elements, discards duplicates, and builds the hash function and
+// the table again, changing the seed for as long as the search for pilots
+// fails.
+void PerfectHashSet::rebuild() const
+{
+    std::string* words = new std::string[slot_count + pending_size];
+
+    for (std::uint32_t slot = 0; slot < slot_count; ++slot)
+    {
+        words[slot] = wordAt(slot);
+    }
+
+    std::string* end = std::move(pending, pending + pending_size, words + slot_count);
+    std::sort(words, end);
+    std::uint32_t count = static_cast<std::uint32_t>(std::unique(words, end) - words);
+
+    delete[] pending;
+    pending = nullptr;
+    pending_size = 0;
+    pending_capacity = 0;
+
+    std::uint32_t* slots = new std::uint32_t[count];
+
+    for (seed = 0; !findPilots(words, count, slots); ++seed)
+    {
+    }
+
+    layOut(words, count, slots);
+
+    delete[] slots;
+    delete[] words;
+}
+
+
+// findPilots() chooses the buckets and a pilot for each of them, storing
+// the slot that each of the given words ends up in, or returns false if
+// the current seed makes that impossible.
+bool PerfectHashSet::findPilots(
+    const std::string* words, std::uint32_t count, std::uint32_t* slots) const
+{
+    delete[] pilots;
+    pilots = nullptr;
+    slot_count = count;
+
+    if (count == 0)
+    {
+        bucket_count = 0;
+        dense_buckets = 0;
+        return true;
+    }
+
+    bucket_count = std::max<std::uint32_t>(2, (count + AVERAGE_BUCKET_SIZE - 1) / AVERAGE_BUCKET_SIZE);
+    dense_buckets = std::max<std::uint32_t>(1, static_cast<std::uint32_t>(
+        static_cast<std::uint64_t>(bucket_count) * 3 / 10));
+    pilots = new std::uint32_t[bucket_count];
+
+    // The words are sorted into their buckets by counting: first[b] is
+    // where bucket b's words begin in members, and first[b + 1] is where
+    // they end.
+    std::uint64_t* hashes = new std::uint64_t[count];
+    std::uint32_t* first = new std::uint32_t[bucket_count + 1];
+    std::uint32_t* members = new std::uint32_t[count];
+    std::fill(first, first + bucket_count + 1, 0);
+
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        hashes[i] = hashStringAsWyhash64(words[i], seed);
+        ++first[bucketOf(hashes[i]) + 1];
+    }
+
+    for (std::uint32_t b = 0; b < bucket_count; ++b)
+    {
+        first[b + 1] += first[b];
+    }
+
+    std::uint32_t* next = new std::uint32_t[bucket_count];
+    std::copy(first, first + bucket_count, next);
+
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        members[next[bucketOf(hashes[i])]++] = i;
+    }
+
+    delete[] next;
+
+    // The buckets are given their pilots largest first.
+    std::uint32_t* order = new std::uint32_t[bucket_count];
+
+    for (std::uint32_t b = 0; b < bucket_count; ++b)
+    {
+        order[b] = b;
+    }
+
+    std::stable_sort(
+        order, order + bucket_count,
+        [first](std::uint32_t a, std::uint32_t b)
+        {
+            return first[a + 1] - first[a] > first[b + 1] - first[b];
+        });
+
+    bool* taken = new bool[count];
+    std::fill(taken, taken + count, false);
+
+    std::uint64_t pilotLimit = std::min<std::uint64_t>(
+        std::max(MIN_PILOTS, PILOTS_PER_WORD * count),
+        std::numeric_limits<std::uint32_t>::max());
+
+    bool found = true;
+
+    for (std::uint32_t k = 0; k < bucket_count && found; ++k)
+    {
+        std::uint32_t b = order[k];
+        std::uint32_t begin = first[b];
+        std::uint32_t end = first[b + 1];
+
+        found = false;
+
+        for (std::uint64_t pilot = 0; pilot < pilotLimit && !found; ++pilot)
+        {
+            // Each word's slot is taken as soon as it's found to be free,
+            // which also keeps two of the bucket's words from sharing one;
+            // if any of them isn't free, the slots taken so far are given
+            // back and the next pilot is tried.
+            std::uint32_t i = begin;
+
+            for (; i < end; ++i)
+            {
+                std::uint32_t slot = slotOf(hashes[members[i]], static_cast<std::uint32_t>(pilot));
+
+                if (taken[slot])
+                {
+                    break;
+                }
+
+                taken[slot] = true;
+                slots[members[i]] = slot;
+            }
+
+            if (i == end)
+            {
+                pilots[b] = static_cast<std::uint32_t>(pilot);
+                found = true;
+            }
+            else
+            {
+                for (std::uint32_t j = begin; j < i; ++j)
+                {
+                    taken[slots[members[j]]] = false;
+                }
+            }
+        }
+    }
+
+    delete[] taken;
+    delete[] order;
+    delete[] members;
+    delete[] first;
+    delete[] hashes;
+
+    return found;
+}
+
+
+// layOut() copies the given words into the arena, each one into the slot
+// that the pilots chose for it.
+void PerfectHashSet::layOut(
+    const std::string* words, std::uint32_t count, const std::uint32_t* slots) const
+{
+    std::uint32_t* newOffsets = new std::uint32_t[count + 1];
+    std::fill(newOffsets, newOffsets + count + 1, 0);
+
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        newOffsets[slots[i] + 1] = static_cast<std::uint32_t>(words[i].size());
+    }
+
+    std::uint64_t total = 0;
+
+    for (std::uint32_t slot = 0; slot < count; ++slot)
+    {
+        total += newOffsets[slot + 1];
+
+        if (total > std::numeric_limits<std::uint32_t>::max())
+        {
+            delete[] newOffsets;
+            throw std::length_error{"PerfectHashSet: words are too long in total"};
+        }
+
+        newOffsets[slot + 1] = static_cast<std::uint32_t>(total);
+    }
+
+    char* newArena = new char[total];
+
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        std::copy(words[i].begin(), words[i].end(), newArena + newOffsets[slots[i]]);
+    }
+
+    delete[] offsets;
+    delete[] arena;
+    offsets = newOffsets;
+    arena = newArena;
+}
+
+
+void PerfectHashSet::copyAll(const PerfectHashSet& s)
+{
+    std::uint32_t* newPilots = nullptr;
+
+    if (s.pilots != nullptr)
+    {
+        newPilots = new std::uint32_t[s.bucket_count];
+        std::copy(s.pilots, s.pilots + s.bucket_count, newPilots);
+    }
+
+    std::uint32_t* newOffsets = new std::uint32_t[s.slot_count + 1];
+    std::copy(s.offsets, s.offsets + s.slot_count + 1, newOffsets);
+
+    char* newArena = new char[s.offsets[s.slot_count]];
+    std::copy(s.arena, s.arena + s.offsets[s.slot_count], newArena);
+
+    delete[] pilots;
+    delete[] offsets;
+    delete[] arena;
+    pilots = newPilots;
+    offsets = newOffsets;
+    arena = newArena;
+
+    seed = s.seed;
+    bucket_count = s.bucket_count;
+    dense_buckets = s.dense_buckets;
+    slot_count = s.slot_count;
+
+    delete[] pending;
+    pending = nullptr;
+    pending_size = 0;
+    pending_capacity = 0;
+
+    if (s.pending_size != 0)
+    {
+        pending = new std::string[s.pending_size];
+        std::copy(s.pending, s.pending + s.pending_size, pending);
+        pending_size = s.pending_size;
+        pending_capacity = s.pending_size;
+    }
+}
+
+
+void PerfectHashSet::swapAll(PerfectHashSet& s)
+{
+    std::swap(seed, s.seed);
+    std::swap(pilots, s.pilots);
+    std::swap(bucket_count, s.bucket_count);
+    std::swap(dense_buckets, s.dense_buckets);
+    std::swap(offsets, s.offsets);
+    std::swap(arena, s.arena);
+    std::swap(slot_count, s.slot_count);
+    std::swap(pending, s.pending);
+    std::swap(pending_size, s.pending_size);
+    std::swap(pending_capacity, s.pending_capacity);
+}
+
@@ -0,0 +1,142 @@
+// PerfectHashSet.hpp
+//
+// ICS 46 Spring 2017
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A PerfectHashSet is a set of strings meant for a dictionary that's built
+// once and then only searched.  Its n words are stored in a table of
+// exactly n slots, and a minimal perfect hash function -- one that maps the
+// n words to the n slots without any collisions -- tells which slot each
+// word is in.  So there are no chains to follow, no probe sequences and no
+// empty slots; a search hashes the word once, reads one slot, and compares
+// the word against the one word in it, whether the word is in the set or
+// not.
+//
+// The hash function is built in the style of PTHash.  Each word's 64-bit
+// hash first chooses one of about n / AVERAGE_BUCKET_SIZE buckets, with
+// the buckets deliberately uneven: 60% of the words go to the first 30% of
+// the buckets.  Each bucket then gets a "pilot," a small number chosen so
+// that combining each of the bucket's words' hashes with the pilot's hash
+// sends them to slots that are all still empty.  The buckets are given
+// their pilots largest first, while most of the slots are still empty and
+// a suitable pilot is easy to find; the many small buckets fill the gaps
+// that remain.  The only thing stored besides the words is one pilot per
+// bucket.  If some bucket can't be given a pilot (which essentially only
+// happens if two words have the same 64-bit hash), the whole search starts
+// over with a different seed for the word hashes.
+//
+// The words themselves are stored one after another in an arena, in the
+// order of their slots, so a slot is just the offset at which its word
+// begins (and the next slot's offset is where it ends).
+//
+// Added elements are collected in a separate buffer, and the first time the
+// set is searched (or frozen) after elements have been added, the hash
+// function and the table are built again from scratch, including the words
+// that were already in the table.
+
+#ifndef PERFECTHASHSET_HPP
+#define PERFECTHASHSET_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "Set.hpp"
+
+
+
+class PerfectHashSet : public Set<std::string>
+{
+public:
+    // The average number of words in a bucket.
+    static constexpr unsigned int AVERAGE_BUCKET_SIZE = 4;
+
+public:
+    // Initializes a PerfectHashSet to be empty.
+    PerfectHashSet();
+
+    // Cleans up the PerfectHashSet so that it leaks no memory.
+    virtual ~PerfectHashSet();
+
+    // Initializes a new PerfectHashSet to be a copy of an existing one.
+    PerfectHashSet(const PerfectHashSet& s);
+
+    // Initializes a new PerfectHashSet whose contents are moved from an
+    // expiring one.
+    PerfectHashSet(PerfectHashSet&& s);
+
+    // Assigns an existing PerfectHashSet into another.
+    PerfectHashSet& operator=(const PerfectHashSet& s);
+
+    // Assigns an expiring PerfectHashSet into another.
+    PerfectHashSet& operator=(PerfectHashSet&& s);
+
+
+    virtual bool isImplemented() const;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  This function runs in amortized
+    // constant time, though the next search pays for rebuilding the table.
+    virtual void add(const std::string& element);
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  This function runs in constant time (apart from
+    // hashing and comparing the element), unless elements have been added
+    // since the last search, in which case it first rebuilds the table,
+    // which takes expected O(n log n) time.
+    virtual bool contains(const std::string& element) const;
+
+
+    // containsView() is equivalent to contains(), but doesn't require the
+    // caller to build an element to look for.
+    virtual bool containsView(std::string_view element) const;
+
+
+    // size() returns the number of elements in the set.  Since duplicates
+    // are only discarded when the table is rebuilt, this function rebuilds
+    // it first, if necessary.
+    virtual unsigned int size() const;
+
+
+    // reserve() makes room in the buffer of added elements for the given
+    // number of elements.
+    virtual void reserve(unsigned int count);
+
+
+    // freeze() builds any newly added elements into the table.
+    virtual void freeze();
+
+
+private:
+    mutable std::uint64_t seed;
+    mutable std::uint32_t* pilots;
+    mutable std::uint32_t bucket_count;
+    mutable std::uint32_t dense_buckets;
+
+    // Slot i holds the word whose characters run from offsets[i] up to
+    // offsets[i + 1] in the arena.
+    mutable std::uint32_t* offsets;
+    mutable char* arena;
+    mutable std::uint32_t slot_count;
+
+    mutable std::string* pending;
+    mutable unsigned int pending_size;
+    mutable unsigned int pending_capacity;
+
+
+private:
+    std::uint32_t bucketOf(std::uint64_t hash) const;
+    std::uint32_t slotOf(std::uint64_t hash, std::uint32_t pilot) const;
+    std::string_view wordAt(std::uint32_t slot) const;
+
+    void rebuild() const;
+    bool findPilots(const std::string* words, std::uint32_t count, std::uint32_t* slots) const;
+    void layOut(const std::string* words, std::uint32_t count, const std::uint32_t* slots) const;
+    void copyAll(const PerfectHashSet& s);
+    void swapAll(PerfectHashSet& s);
+};
+
+
+
+#endif // PERFECTHASHSET_HPP
@@ -0,0 +1,588 @@
+// PersistentAVLSet.hpp
+//
+// ICS 46 Spring 2017
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A PersistentAVLSet is an AVL tree whose nodes are never modified once
+// they've been built.  Adding an element doesn't change the tree; instead,
+// it builds new copies of the nodes on the path from the root down to where
+// the element belongs (rebalancing them as it goes), and those new nodes
+// share every untouched subtree with the old tree.  The result is a new
+// tree, which is published as the set's current contents, while the old
+// tree remains intact for as long as anyone still refers to it.  Each add()
+// therefore builds O(log n) new nodes, rather than changing existing ones.
+//
+// Each version of the tree, along with its size, is a Snapshot.  A reader
+// that calls snapshot() gets the current version in constant time, and can
+// search it for as long as it likes without any further synchronization;
+// nothing that another thread does to the set can change it.  Copying a
+// PersistentAVLSet is just as cheap, since the copy can share the original's
+// current version rather than copying its nodes.
+//
+// Nodes are reference-counted with std::shared_ptr, so a node is freed as
+// soon as no version of the tree refers to it any longer.  The set's
+// current version, though, is published through an atomic pointer, so that
+// contains() and size() needn't copy a std::shared_ptr (which, with the
+// standard library's atomic operations on std::shared_ptr, takes a lock as
+// well as changing a reference count).  Instead, a thread that reads the
+// current version counts itself among the set's readers while it uses it,
+// which costs one atomic increment and one decrement of a single counter.
+// When an add() replaces a version, the old one is "retired" rather than
+// freed, and the retired versions are freed only once a moment is seen when
+// nobody is reading, since nobody can still be using them after that.  So
+// any number of threads can call add(), contains(), size() and snapshot()
+// at the same time, without locks.  When two threads add elements at once,
+// the one whose new version is published second notices that the version
+// it started from has been replaced, and redoes its insertion on the newer
+// one.  (If the set is never without a reader, retired versions pile up
+// until it is, or until it's destroyed.)
+
+#ifndef PERSISTENTAVLSET_HPP
+#define PERSISTENTAVLSET_HPP
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include "Set.hpp"
+
+
+
+template <typename T>
+class PersistentAVLSet : public Set<T>
+{
+private:
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+
+public:
+    // A Snapshot is one version of the set's contents, which never changes.
+    class Snapshot
+    {
+    public:
+        // contains() returns true if the given element is in this version
+        // of the set, false otherwise.  This function always runs in
+        // O(log n) time.
+        bool contains(typename Set<T>::KeyView element) const;
+
+        // size() returns the number of elements in this version of the set.
+        unsigned int size() const;
+
+        // forEachInOrder() calls the given function once with each element
+        // in this version of the set, in ascending order.  This function
+        // runs in O(n) time.
+        template <typename Visitor>
+        void forEachInOrder(Visitor visit) const;
+
+    private:
+        friend class PersistentAVLSet;
+
+        NodePtr root;
+        unsigned int count = 0;
+
+        // The next retired version, once this one has been retired.
+        mutable const Snapshot* next_retired = nullptr;
+    };
+
+public:
+    // Initializes a PersistentAVLSet to be empty.
+    PersistentAVLSet();
+
+    // Cleans up the PersistentAVLSet so that it leaks no memory.  Nodes
+    // that are still part of a Snapshot that someone holds survive until
+    // the Snapshot is released.  No other thread may be using the set.
+    virtual ~PersistentAVLSet();
+
+    // Initializes a new PersistentAVLSet to be a copy of an existing one.
+    // The two share the existing one's current version, so this takes
+    // constant time.
+    PersistentAVLSet(const PersistentAVLSet& s);
+
+    // Initializes a new PersistentAVLSet whose contents are moved from an
+    // expiring one.
+    PersistentAVLSet(PersistentAVLSet&& s);
+
+    // Assigns an existing PersistentAVLSet into another, in constant time.
+    PersistentAVLSet& operator=(const PersistentAVLSet& s);
+
+    // Assigns an expiring PersistentAVLSet into another.
+    PersistentAVLSet& operator=(PersistentAVLSet&& s);
+
+
+    virtual bool isImplemented() const;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  This function runs in O(log n)
+    // time, building O(log n) new nodes, unless it has to start over
+    // because another thread added an element at the same time.
+    virtual void add(const T& element);
+
+
+    // contains() returns true if the given element is in the set's current
+    // version, false otherwise.  This function always runs in O(log n) time,
+    // and neither locks nor changes any reference counts.
+    virtual bool contains(const T& element) const;
+
+
+    // containsView() is equivalent to contains(), but doesn't require the
+    // caller to build an element to look for.
+    virtual bool containsView(typename Set<T>::KeyView element) const;
+
+
+    // size() returns the number of elements in the set's current version.
+    virtual unsigned int size() const;
+
+
+    // snapshot() returns the set's current version, which is unaffected by
+    // any elements added afterward.  This function runs in constant time,
+    // though unlike contains(), it allocates the Snapshot it returns.
+    std::shared_ptr<const Snapshot> snapshot() const;
+
+
+    // forEachInOrder() calls the given function once with each element in
+    // the set's current version, in ascending order.  This function runs in
+    // O(n) time.
+    template <typename Visitor>
+    void forEachInOrder(Visitor visit) const;
+
+
+private:
+    // An AVL tree of height h has at least F(h+2)-1 nodes, where F is the
+    // Fibonacci sequence, so no tree with fewer than 2^32 nodes is taller
+    // than this.
+    static constexpr int MAX_HEIGHT = 64;
+
+    struct Node
+    {
+        Node(const T& key, NodePtr left, NodePtr right);
+
+        T key;
+        NodePtr left;
+        NodePtr right;
+        int height;
+    };
+
+    // A Reader counts itself among the set's readers for as long as it
+    // exists, so that the version it reads can't be freed in the meantime.
+    class Reader
+    {
+    public:
+        explicit Reader(const PersistentAVLSet& s);
+        ~Reader();
+
+        const Snapshot* version() const;
+
+    private:
+        const PersistentAVLSet& s;
+    };
+
+    std::atomic<const Snapshot*> current;
+    mutable std::atomic<unsigned int> readers;
+    std::atomic<const Snapshot*> retired;
+
+
+private:
+    Snapshot* copyCurrent() const;
+    void retire(const Snapshot* version);
+    void pushRetired(const Snapshot* first, const Snapshot* last);
+    static void freeRetired(const Snapshot* version);
+
+    static int heightOf(const NodePtr& node);
+    static NodePtr balance(const T& key, NodePtr left, NodePtr right);
+    static NodePtr insert(const NodePtr& node, const T& element, bool& added);
+};
+
+
+
+template <typename T>
+PersistentAVLSet<T>::Node::Node(const T& key, NodePtr left, NodePtr right)
+    : key{key}, left{std::move(left)}, right{std::move(right)}
+{
+    int leftHeight = heightOf(this->left);
+    int rightHeight = heightOf(this->right);
+    height = (leftHeight > rightHeight ? leftHeight : rightHeight) + 1;
+}
+
+
+template <typename T>
+bool PersistentAVLSet<T>::Snapshot::contains(typename Set<T>::KeyView element) const
+{
+    const Node* node = root.get();
+
+    while (node != nullptr)
+    {
+        if (element < node->key)
+        {
+            node = node->left.get();
+        }
+        else if (node->key < element)
+        {
+            node = node->right.get();
+        }
+        else
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+template <typename T>
+unsigned int PersistentAVLSet<T>::Snapshot::size() const
+{
+    return count;
+}
+
+
+template <typename T>
+template <typename Visitor>
+void PersistentAVLSet<T>::Snapshot::forEachInOrder(Visitor visit) const
+{
+    const Node* stack[MAX_HEIGHT];
+    int depth = 0;
+    const Node* node = root.get();
+
+    while (node != nullptr || depth > 0)
+    {
+        while (node != nullptr)
+        {
+            stack[depth++] = node;
+            node = node->left.get();
+        }
+
+        node = stack[--depth];
+        visit(node->key);
+        node = node->right.get();
+    }
+}
+
+
+template <typename T>
+PersistentAVLSet<T>::Reader::Reader(const PersistentAVLSet& s)
+    : s{s}
+{
+    s.readers.fetch_add(1);
+}
+
+
+template <typename T>
+PersistentAVLSet<T>::Reader::~Reader()
+{
+    s.readers.fetch_sub(1);
+}
+
+
+// version() returns the set's current version, which remains intact for as
+// long as the Reader exists, even if it's replaced in the meantime.
+template <typename T>
+const typename PersistentAVLSet<T>::Snapshot* PersistentAVLSet<T>::Reader::version() const
+{
+    return s.current.load();
+}
+
+
+template <typename T>
+PersistentAVLSet<T>::PersistentAVLSet()
+    : current{new Snapshot}, readers{0}, retired{nullptr}
+{
+}
+
+
+template <typename T>
+PersistentAVLSet<T>::~PersistentAVLSet()
+{
+    delete current.load();
+    freeRetired(retired.load());
+}
+
+
+template <typename T>
+PersistentAVLSet<T>::PersistentAVLSet(const PersistentAVLSet& s)
+    : current{s.copyCurrent()}, readers{0}, retired{nullptr}
+{
+}
+
+
+template <typename T>
+PersistentAVLSet<T>::PersistentAVLSet(PersistentAVLSet&& s)
+    : current{new Snapshot}, readers{0}, retired{nullptr}
+{
+    current.store(s.current.exchange(current.load()));
+}
+
+
+template <typename T>
+PersistentAVLSet<T>& PersistentAVLSet<T>::operator=(const PersistentAVLSet& s)
+{
+    retire(current.exchange(s.copyCurrent()));
+    return *this;
+}
+
+
+template <typename T>
+PersistentAVLSet<T>& PersistentAVLSet<T>::operator=(PersistentAVLSet&& s)
+{
+    current.store(s.current.exchange(current.load()));
+    return *this;
+}
+
+
+template <typename T>
+bool PersistentAVLSet<T>::isImplemented() const
+{
+    return true;
+}
+
+
+template <typename T>
+void PersistentAVLSet<T>::add(const T& element)
+{
+    const Snapshot* replaced = nullptr;
+
+    {
+        Reader reader{*this};
+        const Snapshot* version = reader.version();
+
+        while (replaced == nullptr)
+        {
+            bool added = false;
+            NodePtr root = insert(version->root, element, added);
+
+            if (!added)
+            {
+                return;
+            }
+
+            std::unique_ptr<Snapshot> next{new Snapshot};
+            next->root = std::move(root);
+            next->count = version->count + 1;
+
+            // If another thread published a version first, this reloads it
+            // into version, and the insertion is redone there.
+            if (current.compare_exchange_weak(version, next.get()))
+            {
+                next.release();
+                replaced = version;
+            }
+        }
+    }
+
+    // The replaced version is retired only once this thread has stopped
+    // reading, so that it doesn't stand in the way of freeing it.
+    retire(replaced);
+}
+
+
+template <typename T>
+bool PersistentAVLSet<T>::contains(const T& element) const
+{
+    return PersistentAVLSet<T>::containsView(element);
+}
+
+
+template <typename T>
+bool PersistentAVLSet<T>::containsView(typename Set<T>::KeyView element) const
+{
+    Reader reader{*this};
+    return reader.version()->contains(element);
+}
+
+
+template <typename T>
+unsigned int PersistentAVLSet<T>::size() const
+{
+    Reader reader{*this};
+    return reader.version()->count;
+}
+
+
+template <typename T>
+std::shared_ptr<const typename PersistentAVLSet<T>::Snapshot> PersistentAVLSet<T>::snapshot() const
+{
+    return std::shared_ptr<const Snapshot>{copyCurrent()};
+}
+
+
+template <typename T>
+template <typename Visitor>
+void PersistentAVLSet<T>::forEachInOrder(Visitor visit) const
+{
+    snapshot()->forEachInOrder(visit);
+}
+
+
+// copyCurrent() returns a new Snapshot that shares the current version's
+// tree, and that its caller owns.
+template <typename T>
+typename PersistentAVLSet<T>::Snapshot* PersistentAVLSet<T>::copyCurrent() const
+{
+    Reader reader{*this};
+    const Snapshot* version = reader.version();
+
+    Snapshot* copy = new Snapshot;
+    copy->root = version->root;
+    copy->count = version->count;
+    return copy;
+}
+
+
+// retire() adds a version that has been replaced to the retired versions,
+// and then frees all of them if nobody is reading.  The retired versions
+// are taken out of the set before the readers are counted, so that every
+// one of them had been replaced before the count was taken: a reader that
+// started after that couldn't have found any of them, so if there were no
+// readers at that moment, none can still be using them.  Otherwise, they're
+// put back for a later call to free.
+template <typename T>
+void PersistentAVLSet<T>::retire(const Snapshot* version)
+{
+    pushRetired(version, version);
+
+    const Snapshot* first = retired.exchange(nullptr);
+
+    if (first == nullptr)
+    {
+        return;
+    }
+
+    if (readers.load() == 0)
+    {
+        freeRetired(first);
+    }
+    else
+    {
+        const Snapshot* last = first;
+
+        while (last->next_retired != nullptr)
+        {
+            last = last->next_retired;
+        }
+
+        pushRetired(first, last);
+    }
+}
+
+
+// pushRetired() pushes a list of retired versions, linked from first to
+// last, onto the front of the set's list.
+template <typename T>
+void PersistentAVLSet<T>::pushRetired(const Snapshot* first, const Snapshot* last)
+{
+    const Snapshot* head = retired.load();
+
+    do
+    {
+        last->next_retired = head;
+    }
+    while (!retired.compare_exchange_weak(head, first));
+}
+
+
+template <typename T>
+void PersistentAVLSet<T>::freeRetired(const Snapshot* version)
+{
+    while (version != nullptr)
+    {
+        const Snapshot* next = version->next_retired;
+        delete version;
+        version = next;
+    }
+}
+
+
+template <typename T>
+int PersistentAVLSet<T>::heightOf(const NodePtr& node)
+{
+    return node == nullptr ? 0 : node->height;
+}
+
+
+// balance() builds a node with the given key and subtrees, whose heights
+// differ by at most two, rotating if necessary to restore the AVL property.
+// Since no existing node may be changed, a rotation builds new copies of
+// the nodes whose children it changes.
+template <typename T>
+typename PersistentAVLSet<T>::NodePtr PersistentAVLSet<T>::balance(
+    const T& key, NodePtr left, NodePtr right)
+{
+    int leftHeight = heightOf(left);
+    int rightHeight = heightOf(right);
+
+    if (leftHeight > rightHeight + 1)
+    {
+        if (heightOf(left->left) >= heightOf(left->right))
+        {
+            return std::make_shared<const Node>(
+                left->key, left->left,
+                std::make_shared<const Node>(key, left->right, std::move(right)));
+        }
+        else
+        {
+            const NodePtr& middle = left->right;
+
+            return std::make_shared<const Node>(
+                middle->key,
+                std::make_shared<const Node>(left->key, left->left, middle->left),
+                std::make_shared<const Node>(key, middle->right, std::move(right)));
+        }
+    }
+    else if (rightHeight > leftHeight + 1)
+    {
+        if (heightOf(right->right) >= heightOf(right->left))
+        {
+            return std::make_shared<const Node>(
+                right->key,
+                std::make_shared<const Node>(key, std::move(left), right->left),
+                right->right);
+        }
+        else
+        {
+            const NodePtr& middle = right->left;
+
+            return std::make_shared<const Node>(
+                middle->key,
+                std::make_shared<const Node>(key, std::move(left), middle->left),
+                std::make_shared<const Node>(right->key, middle->right, right->right));
+        }
+    }
+    else
+    {
+        return std::make_shared<const Node>(key, std::move(left), std::move(right));
+    }
+}
+
+
+// insert() returns the root of a tree that holds the element along with
+// everything in the tree rooted at the given node.  If the element is
+// already there, the given node itself is returned, and nothing is built.
+// The recursion is no deeper than the tree is tall.
+template <typename T>
+typename PersistentAVLSet<T>::NodePtr PersistentAVLSet<T>::insert(
+    const NodePtr& node, const T& element, bool& added)
+{
+    if (node == nullptr)
+    {
+        added = true;
+        return std::make_shared<const Node>(element, nullptr, nullptr);
+    }
+    else if (element < node->key)
+    {
+        NodePtr left = insert(node->left, element, added);
+        return added ? balance(node->key, std::move(left), node->right) : node;
+    }
+    else if (node->key < element)
+    {
+        NodePtr right = insert(node->right, element, added);
+        return added ? balance(node->key, node->left, std::move(right)) : node;
+    }
+    else
+    {
+        return node;
+    }
+}
+
+
+
+#endif // PERSISTENTAVLSET_HPP
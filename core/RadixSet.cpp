@@ -0,0 +1,336 @@
+// RadixSet.cpp
+//
+// ICS 46 Spring 2017
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include "RadixSet.hpp"
+
+
+
+namespace
+{
+    // The number of characters that reserve() sets aside in the arena for
+    // each word it's told to expect.  Most of a typical word is a prefix
+    // shared with another word, so only a few of its characters are stored.
+    constexpr std::uint32_t TYPICAL_SUFFIX_LENGTH = 4;
+
+    constexpr std::uint32_t MAX_WORD_LENGTH = 65535;
+}
+
+
+
+RadixSet::RadixSet()
+    : nodes{nullptr}, node_count{0}, node_capacity{0}, word_count{0},
+      arena{nullptr}, arena_size{0}, arena_capacity{0}
+{
+    resizeNodes(16);
+    createNode(0, 0, false);
+}
+
+
+RadixSet::~RadixSet()
+{
+    delete[] nodes;
+    delete[] arena;
+}
+
+
+RadixSet::RadixSet(const RadixSet& s)
+{
+    copyAll(s);
+}
+
+
+RadixSet::RadixSet(RadixSet&& s)
+    : RadixSet{}
+{
+    std::swap(nodes, s.nodes);
+    std::swap(node_count, s.node_count);
+    std::swap(node_capacity, s.node_capacity);
+    std::swap(word_count, s.word_count);
+    std::swap(arena, s.arena);
+    std::swap(arena_size, s.arena_size);
+    std::swap(arena_capacity, s.arena_capacity);
+}
+
+
+RadixSet& RadixSet::operator=(const RadixSet& s)
+{
+    if (this != &s)
+    {
+        delete[] nodes;
+        delete[] arena;
+        copyAll(s);
+    }
+
+    return *this;
+}
+
+
+RadixSet& RadixSet::operator=(RadixSet&& s)
+{
+    std::swap(nodes, s.nodes);
+    std::swap(node_count, s.node_count);
+    std::swap(node_capacity, s.node_capacity);
+    std::swap(word_count, s.word_count);
+    std::swap(arena, s.arena);
+    std::swap(arena_size, s.arena_size);
+    std::swap(arena_capacity, s.arena_capacity);
+    return *this;
+}
+
+
+bool RadixSet::isImplemented() const
+{
+    return true;
+}
+
+
+void RadixSet::add(const std::string& element)
+{
+    if (element.size() > MAX_WORD_LENGTH)
+    {
+        throw std::length_error{"RadixSet: element is too long"};
+    }
+
+    std::string_view rest{element};
+    std::uint32_t node = 0;
+
+    while (!rest.empty())
+    {
+        std::uint32_t previous;
+        std::uint32_t child = findChild(node, rest[0], previous);
+
+        if (child == 0)
+        {
+            // No edge begins with the next character, so the rest of the
+            // element becomes the label of a new leaf, which is linked in
+            // among its siblings after the one that precedes it.
+            std::uint32_t label = appendToArena(rest);
+            std::uint32_t leaf = createNode(
+                label, static_cast<std::uint32_t>(rest.size()), true);
+
+            if (previous == 0)
+            {
+                nodes[leaf].next_sibling = nodes[node].first_child;
+                nodes[node].first_child = leaf;
+            }
+            else
+            {
+                nodes[leaf].next_sibling = nodes[previous].next_sibling;
+                nodes[previous].next_sibling = leaf;
+            }
+
+            ++word_count;
+            return;
+        }
+
+        std::string_view label = labelOf(child);
+        std::uint32_t shared = 1;
+
+        while (shared < label.size() && shared < rest.size()
+            && label[shared] == rest[shared])
+        {
+            ++shared;
+        }
+
+        if (shared < label.size())
+        {
+            // The element leaves the edge partway along its label, so the
+            // edge is split in two there: the child keeps the shared part
+            // of the label, and a new node below it takes the rest, along
+            // with the child's children and whether it ended a word.
+            std::uint32_t below = createNode(
+                nodes[child].label + shared, nodes[child].length - shared,
+                nodes[child].terminal);
+
+            nodes[below].first_child = nodes[child].first_child;
+            nodes[child].first_child = below;
+            nodes[child].length = static_cast<std::uint16_t>(shared);
+            nodes[child].terminal = false;
+        }
+
+        node = child;
+        rest.remove_prefix(shared);
+    }
+
+    if (!nodes[node].terminal)
+    {
+        nodes[node].terminal = true;
+        ++word_count;
+    }
+}
+
+
+bool RadixSet::contains(const std::string& element) const
+{
+    return containsView(element);
+}
+
+
+bool RadixSet::containsView(std::string_view element) const
+{
+    std::uint32_t node = 0;
+
+    while (!element.empty())
+    {
+        std::uint32_t previous;
+        node = findChild(node, element[0], previous);
+
+        if (node == 0)
+        {
+            return false;
+        }
+
+        std::string_view label = labelOf(node);
+
+        if (element.size() < label.size()
+            || element.compare(0, label.size(), label) != 0)
+        {
+            return false;
+        }
+
+        element.remove_prefix(label.size());
+    }
+
+    return nodes[node].terminal;
+}
+
+
+unsigned int RadixSet::size() const
+{
+    return word_count;
+}
+
+
+void RadixSet::reserve(unsigned int count)
+{
+    // Each word adds at most two nodes: a leaf, and the node created when
+    // the edge it leaves is split.
+    if (2 * count + 1 > node_capacity)
+    {
+        resizeNodes(2 * count + 1);
+    }
+
+    std::uint32_t characters = count * TYPICAL_SUFFIX_LENGTH;
+
+    if (characters > arena_capacity)
+    {
+        resizeArena(characters);
+    }
+}
+
+
+void RadixSet::freeze()
+{
+    resizeNodes(node_count);
+    resizeArena(arena_size);
+}
+
+
+// findChild() returns the child of the given node whose label begins with
+// the given character, or 0 if there is none.  Either way, it also stores
+// the last child whose label begins with a smaller character (or 0 if there
+// is none) into its last parameter, since that's where a new child that
+// begins with the given character would be linked in.
+std::uint32_t RadixSet::findChild(
+    std::uint32_t node, char first, std::uint32_t& previous) const
+{
+    unsigned char wanted = static_cast<unsigned char>(first);
+    std::uint32_t child = nodes[node].first_child;
+    previous = 0;
+
+    while (child != 0
+        && static_cast<unsigned char>(arena[nodes[child].label]) < wanted)
+    {
+        previous = child;
+        child = nodes[child].next_sibling;
+    }
+
+    if (child != 0 && arena[nodes[child].label] == first)
+    {
+        return child;
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+
+std::string_view RadixSet::labelOf(std::uint32_t node) const
+{
+    return std::string_view{arena + nodes[node].label, nodes[node].length};
+}
+
+
+std::uint32_t RadixSet::createNode(
+    std::uint32_t label, std::uint32_t length, bool terminal)
+{
+    if (node_count == node_capacity)
+    {
+        resizeNodes(node_capacity * 2);
+    }
+
+    std::uint32_t node = node_count++;
+    nodes[node] = Node{label, 0, 0, static_cast<std::uint16_t>(length), terminal};
+    return node;
+}
+
+
+// appendToArena() copies the given characters onto the end of the arena,
+// returning the offset at which they begin.
+std::uint32_t RadixSet::appendToArena(std::string_view characters)
+{
+    if (arena_capacity - arena_size < characters.size())
+    {
+        resizeArena(std::max<std::uint32_t>(
+            arena_capacity * 2, arena_size + static_cast<std::uint32_t>(characters.size())));
+    }
+
+    std::uint32_t offset = arena_size;
+    std::copy(characters.begin(), characters.end(), arena + arena_size);
+    arena_size += static_cast<std::uint32_t>(characters.size());
+    return offset;
+}
+
+
+void RadixSet::resizeNodes(std::uint32_t capacity)
+{
+    Node* newNodes = new Node[capacity];
+    std::copy(nodes, nodes + node_count, newNodes);
+
+    delete[] nodes;
+    nodes = newNodes;
+    node_capacity = capacity;
+}
+
+
+void RadixSet::resizeArena(std::uint32_t capacity)
+{
+    char* newArena = new char[capacity];
+    std::copy(arena, arena + arena_size, newArena);
+
+    delete[] arena;
+    arena = newArena;
+    arena_capacity = capacity;
+}
+
+
+void RadixSet::copyAll(const RadixSet& s)
+{
+    nodes = new Node[s.node_count];
+    node_count = s.node_count;
+    node_capacity = s.node_count;
+    word_count = s.word_count;
+    std::copy(s.nodes, s.nodes + s.node_count, nodes);
+
+    arena = new char[s.arena_size];
+    arena_size = s.arena_size;
+    arena_capacity = s.arena_size;
+    std::copy(s.arena, s.arena + s.arena_size, arena);
+}
+
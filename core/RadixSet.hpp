@@ -0,0 +1,137 @@
+// RadixSet.hpp
+//
+// ICS 46 Spring 2017
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A RadixSet is a set of strings stored in a radix tree (a path-compressed
+// trie).  Rather than storing each word separately, the tree stores each
+// shared prefix once: every edge is labeled with a string of characters,
+// the words in the set are the labels read along the paths from the root
+// to the nodes marked as ends of words, and no two edges leaving the same
+// node begin with the same character.  A node with only one child that
+// isn't the end of a word would be redundant, so there are none; a chain
+// of such nodes is compressed into a single edge with a longer label.
+//
+// Searching for a word follows one edge for each label along its path,
+// comparing characters of the word only against that label, so it takes
+// time proportional to the length of the word (and the number of siblings
+// it passes over), no matter how many words are in the set, and it stops at
+// the first character that doesn't match.
+//
+// As in a CompactAVLSet, the nodes live in one array and refer to each
+// other by their 32-bit indexes, and the characters of the labels live in a
+// second array (the "arena").  Each node's label is a slice of the arena.
+// When a word is added, only the part of it that follows the longest prefix
+// it shares with a word already in the set is appended to the arena;
+// splitting an edge in two splits its slice and copies no characters.  The
+// children of a node are a linked list (the node refers to its first child
+// and each child to its next sibling), kept in ascending order by the first
+// character of their labels.  Each node is 16 bytes, and there are at most
+// two nodes for every word.  A word can be at most 65,535 characters long.
+
+#ifndef RADIXSET_HPP
+#define RADIXSET_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "Set.hpp"
+
+
+
+class RadixSet : public Set<std::string>
+{
+public:
+    // Initializes a RadixSet to be empty.
+    RadixSet();
+
+    // Cleans up the RadixSet so that it leaks no memory.
+    virtual ~RadixSet();
+
+    // Initializes a new RadixSet to be a copy of an existing one.
+    RadixSet(const RadixSet& s);
+
+    // Initializes a new RadixSet whose contents are moved from an
+    // expiring one.
+    RadixSet(RadixSet&& s);
+
+    // Assigns an existing RadixSet into another.
+    RadixSet& operator=(const RadixSet& s);
+
+    // Assigns an expiring RadixSet into another.
+    RadixSet& operator=(RadixSet&& s);
+
+
+    virtual bool isImplemented() const;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  This function runs in time
+    // proportional to the length of the element, plus the occasional
+    // linear-time growth of one of the arrays.  It throws a
+    // std::length_error if the element is too long.
+    virtual void add(const std::string& element);
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  This function runs in time proportional to the
+    // length of the element.
+    virtual bool contains(const std::string& element) const;
+
+
+    // containsView() is equivalent to contains(), but doesn't require the
+    // caller to build an element to look for.
+    virtual bool containsView(std::string_view element) const;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const;
+
+
+    // reserve() grows the node array so that it can hold the nodes that the
+    // given number of elements could need, and the arena so that it can
+    // hold a typical word's unshared suffix for each of them.
+    virtual void reserve(unsigned int count);
+
+
+    // freeze() trims the node array and the arena to exactly the size that
+    // they need.
+    virtual void freeze();
+
+
+private:
+    struct Node
+    {
+        std::uint32_t label;
+        std::uint32_t first_child;
+        std::uint32_t next_sibling;
+        std::uint16_t length;
+        bool terminal;
+    };
+
+    // Node 0 is the root, whose label is empty.  Since the root is nobody's
+    // child or sibling, index 0 also stands for "no node" in the links.
+    Node* nodes;
+    std::uint32_t node_count;
+    std::uint32_t node_capacity;
+    unsigned int word_count;
+
+    char* arena;
+    std::uint32_t arena_size;
+    std::uint32_t arena_capacity;
+
+
+private:
+    std::uint32_t findChild(std::uint32_t node, char first, std::uint32_t& previous) const;
+    std::string_view labelOf(std::uint32_t node) const;
+    std::uint32_t createNode(std::uint32_t label, std::uint32_t length, bool terminal);
+    std::uint32_t appendToArena(std::string_view characters);
+
+    void resizeNodes(std::uint32_t capacity);
+    void resizeArena(std::uint32_t capacity);
+    void copyAll(const RadixSet& s);
+};
+
+
+
+#endif // RADIXSET_HPP
@@ -0,0 +1,438 @@
+// RobinHoodSet.hpp
+//
+// ICS 46 Spring 2017
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A RobinHoodSet is an implementation of a Set that is an open-addressed
+// hash table using Robin Hood hashing.  Unlike HashSet, there are no linked
+// lists: every key lives directly in one contiguous array of slots, so a
+// lookup touches a short run of adjacent memory rather than chasing
+// pointers around the heap.
+//
+// Each slot remembers how far its key has been displaced from its "home"
+// slot (its probe distance).  When an element is being inserted and it
+// finds a slot whose occupant is closer to home than the new element is,
+// the two trade places and insertion continues with the displaced key.
+// This keeps probe distances short and nearly uniform, and it lets a
+// failed lookup stop as soon as it reaches a slot whose occupant is closer
+// to home than the probe is.
+//
+// The table is kept at a power-of-two capacity and doubles whenever the
+// ratio of size to capacity would exceed 0.9, or whenever an insertion's
+// probe distance exceeds MAX_PROBE_LENGTH while the table is at least half
+// full.  Elements are removed with backward-shift deletion, so no
+// tombstones are ever left behind.
+
+#ifndef ROBINHOODSET_HPP
+#define ROBINHOODSET_HPP
+
+#include <functional>
+#include <utility>
+#include "FunctionHasher.hpp"
+#include "Set.hpp"
+
+
+
+template <typename T, typename Hasher = FunctionHasher<T>>
+class RobinHoodSet : public Set<T>
+{
+public:
+    // The default capacity of the RobinHoodSet before anything has been
+    // added to it.  This must be a power of two.
+    static constexpr unsigned int DEFAULT_CAPACITY = 16;
+
+    // The longest probe distance an insertion may reach before the table
+    // is grown (provided the table is at least half full; growing a sparse
+    // table would not help a poor hash function).
+    static constexpr unsigned int MAX_PROBE_LENGTH = 32;
+
+    // A HashFunction
+    typedef typename FunctionHasher<T>::HashFunction HashFunction;
+
+public:
+    // Initializes a RobinHoodSet to be empty, so that it will use the given
+    // hasher whenever it needs to hash an element.  (With the default
+    // Hasher, this can be any hash function.)
+    RobinHoodSet(Hasher hashFunction = Hasher{});
+
+    // Cleans up the RobinHoodSet so that it leaks no memory.
+    virtual ~RobinHoodSet();
+
+    // Initializes a new RobinHoodSet to be a copy of an existing one.
+    RobinHoodSet(const RobinHoodSet& s);
+
+    // Initializes a new RobinHoodSet whose contents are moved from an
+    // expiring one.
+    RobinHoodSet(RobinHoodSet&& s);
+
+    // Assigns an existing RobinHoodSet into another.
+    RobinHoodSet& operator=(const RobinHoodSet& s);
+
+    // Assigns an expiring RobinHoodSet into another.
+    RobinHoodSet& operator=(RobinHoodSet&& s);
+
+
+    virtual bool isImplemented() const;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  This function runs in linear time
+    // when the table is grown and in expected constant time otherwise.
+    virtual void add(const T& element);
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  This function runs in expected constant time, and
+    // never examines more than the longest probe distance in the table.
+    virtual bool contains(const T& element) const;
+
+
+    // containsView() is equivalent to contains(), but doesn't require the
+    // caller to build an element to look for.
+    virtual bool containsView(typename Set<T>::KeyView element) const;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const;
+
+
+    // reserve() grows the table, if necessary, so that it can hold the
+    // given number of elements without growing again.
+    virtual void reserve(unsigned int count);
+
+
+    // remove() removes an element from the set, if it's there.  The slots
+    // that follow it are shifted back by one, so that no tombstones are
+    // needed and later lookups can still stop early.
+    void remove(const T& element);
+
+
+private:
+    struct Slot
+    {
+        T key;
+        unsigned int hash;
+
+        // The probe distance of this slot's key, plus one; zero means
+        // that the slot is empty.
+        unsigned int distance;
+    };
+
+    Hasher hashFunction;
+    Slot* table;
+    unsigned int table_size;
+    unsigned int table_capacity;
+    unsigned int table_shift;
+    unsigned int longest_probe;
+
+
+private:
+    unsigned int homeOf(unsigned int hash) const;
+    int find(typename Set<T>::KeyView element, unsigned int hash) const;
+    unsigned int place(T key, unsigned int hash);
+    void rehash(unsigned int capacity);
+    void allocate(unsigned int capacity);
+    void copyAll(const RobinHoodSet& s);
+};
+
+
+
+template <typename T, typename Hasher>
+RobinHoodSet<T, Hasher>::RobinHoodSet(Hasher hashFunction)
+    : hashFunction{hashFunction}
+{
+    allocate(DEFAULT_CAPACITY);
+}
+
+
+template <typename T, typename Hasher>
+RobinHoodSet<T, Hasher>::~RobinHoodSet()
+{
+    delete[] table;
+}
+
+
+template <typename T, typename Hasher>
+RobinHoodSet<T, Hasher>::RobinHoodSet(const RobinHoodSet& s)
+    : hashFunction{s.hashFunction}
+{
+    copyAll(s);
+}
+
+
+template <typename T, typename Hasher>
+RobinHoodSet<T, Hasher>::RobinHoodSet(RobinHoodSet&& s)
+    : hashFunction{s.hashFunction}
+{
+    allocate(DEFAULT_CAPACITY);
+    std::swap(table, s.table);
+    std::swap(table_size, s.table_size);
+    std::swap(table_capacity, s.table_capacity);
+    std::swap(table_shift, s.table_shift);
+    std::swap(longest_probe, s.longest_probe);
+}
+
+
+template <typename T, typename Hasher>
+RobinHoodSet<T, Hasher>& RobinHoodSet<T, Hasher>::operator=(const RobinHoodSet& s)
+{
+    if (this != &s)
+    {
+        delete[] table;
+        hashFunction = s.hashFunction;
+        copyAll(s);
+    }
+
+    return *this;
+}
+
+
+template <typename T, typename Hasher>
+RobinHoodSet<T, Hasher>& RobinHoodSet<T, Hasher>::operator=(RobinHoodSet&& s)
+{
+    std::swap(hashFunction, s.hashFunction);
+    std::swap(table, s.table);
+    std::swap(table_size, s.table_size);
+    std::swap(table_capacity, s.table_capacity);
+    std::swap(table_shift, s.table_shift);
+    std::swap(longest_probe, s.longest_probe);
+    return *this;
+}
+
+
+template <typename T, typename Hasher>
+bool RobinHoodSet<T, Hasher>::isImplemented() const
+{
+    return true;
+}
+
+
+template <typename T, typename Hasher>
+void RobinHoodSet<T, Hasher>::add(const T& element)
+{
+    unsigned int hash = hashFunction(element);
+
+    if (find(element, hash) >= 0)
+    {
+        return;
+    }
+
+    if (static_cast<double>(table_size + 1) > 0.9 * table_capacity)
+    {
+        rehash(table_capacity * 2);
+    }
+
+    unsigned int probe = place(element, hash);
+    ++table_size;
+
+    if (probe > MAX_PROBE_LENGTH && table_size * 2 >= table_capacity)
+    {
+        rehash(table_capacity * 2);
+    }
+}
+
+
+template <typename T, typename Hasher>
+bool RobinHoodSet<T, Hasher>::contains(const T& element) const
+{
+    return find(element, hashFunction(element)) >= 0;
+}
+
+
+template <typename T, typename Hasher>
+bool RobinHoodSet<T, Hasher>::containsView(typename Set<T>::KeyView element) const
+{
+    return find(element, hashFunction(element)) >= 0;
+}
+
+
+template <typename T, typename Hasher>
+unsigned int RobinHoodSet<T, Hasher>::size() const
+{
+    return table_size;
+}
+
+
+template <typename T, typename Hasher>
+void RobinHoodSet<T, Hasher>::reserve(unsigned int count)
+{
+    unsigned int capacity = table_capacity;
+
+    while (static_cast<double>(count) > 0.9 * capacity)
+    {
+        capacity *= 2;
+    }
+
+    if (capacity > table_capacity)
+    {
+        rehash(capacity);
+    }
+}
+
+
+template <typename T, typename Hasher>
+void RobinHoodSet<T, Hasher>::remove(const T& element)
+{
+    int found = find(element, hashFunction(element));
+
+    if (found < 0)
+    {
+        return;
+    }
+
+    unsigned int mask = table_capacity - 1;
+    unsigned int hole = static_cast<unsigned int>(found);
+    unsigned int next = (hole + 1) & mask;
+
+    while (table[next].distance > 1)
+    {
+        table[hole].key = std::move(table[next].key);
+        table[hole].hash = table[next].hash;
+        table[hole].distance = table[next].distance - 1;
+
+        hole = next;
+        next = (next + 1) & mask;
+    }
+
+    table[hole].key = T{};
+    table[hole].distance = 0;
+    --table_size;
+}
+
+
+template <typename T, typename Hasher>
+unsigned int RobinHoodSet<T, Hasher>::homeOf(unsigned int hash) const
+{
+    // Fibonacci hashing spreads the high-order bits of the product into
+    // the index, so weak hash functions don't cluster in the low bits.
+    return (hash * 2654435769u) >> table_shift;
+}
+
+
+template <typename T, typename Hasher>
+int RobinHoodSet<T, Hasher>::find(typename Set<T>::KeyView element, unsigned int hash) const
+{
+    unsigned int mask = table_capacity - 1;
+    unsigned int index = homeOf(hash);
+
+    for (unsigned int distance = 1; distance <= longest_probe; ++distance)
+    {
+        const Slot& slot = table[index];
+
+        if (slot.distance < distance)
+        {
+            return -1;
+        }
+
+        if (slot.hash == hash && slot.key == element)
+        {
+            return static_cast<int>(index);
+        }
+
+        index = (index + 1) & mask;
+    }
+
+    return -1;
+}
+
+
+template <typename T, typename Hasher>
+unsigned int RobinHoodSet<T, Hasher>::place(T key, unsigned int hash)
+{
+    unsigned int mask = table_capacity - 1;
+    unsigned int index = homeOf(hash);
+    unsigned int distance = 1;
+    unsigned int probe = 1;
+
+    while (table[index].distance != 0)
+    {
+        if (table[index].distance < distance)
+        {
+            if (distance > longest_probe)
+            {
+                longest_probe = distance;
+            }
+
+            std::swap(key, table[index].key);
+            std::swap(hash, table[index].hash);
+            std::swap(distance, table[index].distance);
+        }
+
+        index = (index + 1) & mask;
+        ++distance;
+        ++probe;
+    }
+
+    table[index].key = std::move(key);
+    table[index].hash = hash;
+    table[index].distance = distance;
+
+    if (distance > longest_probe)
+    {
+        longest_probe = distance;
+    }
+
+    return probe;
+}
+
+
+template <typename T, typename Hasher>
+void RobinHoodSet<T, Hasher>::rehash(unsigned int capacity)
+{
+    Slot* old = table;
+    unsigned int oldCapacity = table_capacity;
+
+    allocate(capacity);
+
+    for (unsigned int i = 0; i < oldCapacity; ++i)
+    {
+        if (old[i].distance != 0)
+        {
+            place(std::move(old[i].key), old[i].hash);
+            ++table_size;
+        }
+    }
+
+    delete[] old;
+}
+
+
+template <typename T, typename Hasher>
+void RobinHoodSet<T, Hasher>::allocate(unsigned int capacity)
+{
+    table = new Slot[capacity];
+    table_size = 0;
+    table_capacity = capacity;
+    table_shift = 32;
+    longest_probe = 0;
+
+    for (unsigned int i = 0; i < capacity; ++i)
+    {
+        table[i].distance = 0;
+    }
+
+    for (unsigned int c = capacity; c > 1; c >>= 1)
+    {
+        --table_shift;
+    }
+}
+
+
+template <typename T, typename Hasher>
+void RobinHoodSet<T, Hasher>::copyAll(const RobinHoodSet& s)
+{
+    table = new Slot[s.table_capacity];
+    table_size = s.table_size;
+    table_capacity = s.table_capacity;
+    table_shift = s.table_shift;
+    longest_probe = s.longest_probe;
+
+    for (unsigned int i = 0; i < table_capacity; ++i)
+    {
+        table[i] = s.table[i];
+    }
+}
+
+
+
+#endif // ROBINHOODSET_HPP
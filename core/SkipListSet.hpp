@@ -4,7 +4,11 @@
 // Project #3: Set the Controls for the Heart of the Sun
 //
 // A SkipListSet is an implementation of a Set that is a skip list, implemented
-// as we discussed in lecture.  A skip list is a sequence of levels
+// as we discussed in lecture.  A skip list is a sequence of levels, each of
+// which is a sorted linked list running from a -INF key to a +INF key.  The
+// bottom level holds every element; each level above it holds a random
+// subset of the elements of the one below, about half of them, so a search
+// can start at the top and skip most of the elements at each level.
 //
 // You are not permitted to use the containers in the C++ Standard Library
 // (such as std::set, std::map, or std::vector), *except* that you can use
@@ -20,15 +24,54 @@
 // A couple of utilities are included here: SkipListKind and SkipListKey.
 // You can feel free to use these as-is and probably will not need to
 // modify them.
+//
+// A SkipListSet can be shared among threads: any number of threads may call
+// add(), contains() and size() at the same time, without locking.
+//
+//   * Each "next" pointer is atomic.  add() links a new node into a level
+//     with a single compare-and-swap on its predecessor's next pointer; if
+//     another thread got there first, it moves forward from that same
+//     predecessor and tries again, so some thread always makes progress.
+//     A new element's nodes are linked in from the bottom level up, so any
+//     node that a search can reach has everything below it in place.
+//
+//   * contains() only ever reads, and never retries or waits on another
+//     thread; the only extra steps an insertion can cost it are those over
+//     nodes that were inserted ahead of it.
+//
+//   * Elements are never removed, so a node, once linked, stays linked for
+//     as long as the set exists.  No thread can ever be left holding a
+//     pointer to a node that's been freed, so no further memory reclamation
+//     scheme is needed: nodes are freed only by the destructor (or by
+//     assignment), which must not run concurrently with anything else.
+//
+// Copying and assignment are not safe while other threads use either set.
+//
+// Only the bottom-level node of an element holds its key.  The nodes above
+// it, which only serve to skip ahead, hold a pointer to that key instead
+// of a copy of it, so a key is stored (and allocated) only once, no matter
+// how many levels its element appears on.
+//
+// The bottom level holds every element in order, so an Iterator is just a
+// pointer to a bottom-level node.  lowerBound() finds the node where an
+// element would be with the same descent that contains() makes, and a set
+// of strings uses it to find the range of its elements that begin with a
+// given prefix.  (See OrderedRange.hpp.)  Since nodes are never removed, an
+// Iterator stays valid while other threads add elements; it visits every
+// element that was in the set when it was created, and may or may not
+// visit elements added since.
 
 #ifndef SKIPLISTSET_HPP
 #define SKIPLISTSET_HPP
 
-#include "Set.hpp"
-/*#include <limits>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
 #include <random>
-*/
-using namespace std; 
+#include <string_view>
+#include <utility>
+#include "OrderedRange.hpp"
+#include "Set.hpp"
 
 
 
@@ -63,6 +106,14 @@ public:
     bool operator==(const SkipListKey& other) const;
     bool operator<(const SkipListKey& other) const;
 
+    // These compare a key against a normal key, given as a view of its
+    // element, so that searching needn't build a key to compare against.
+    bool equals(typename Set<T>::KeyView element) const;
+    bool lessThan(typename Set<T>::KeyView element) const;
+
+    // element() returns the element of a normal key.
+    const T& element() const;
+
 private:
     SkipListKind kind;
     T key;
@@ -102,11 +153,73 @@ bool SkipListKey<T>::operator<(const SkipListKey& other) const
 }
 
 
+template <typename T>
+bool SkipListKey<T>::equals(typename Set<T>::KeyView element) const
+{
+    return kind == SkipListKind::Normal && key == element;
+}
+
+
+template <typename T>
+bool SkipListKey<T>::lessThan(typename Set<T>::KeyView element) const
+{
+    return kind == SkipListKind::NegInf
+        || (kind == SkipListKind::Normal && key < element);
+}
+
+
+template <typename T>
+const T& SkipListKey<T>::element() const
+{
+    return key;
+}
+
+
 
 
 template <typename T>
 class SkipListSet : public Set<T>
 {
+public:
+    // The number of levels in the skip list, which is plenty for any
+    // number of elements that an unsigned int can count.
+    static constexpr unsigned int MAX_LEVELS = 32;
+
+private:
+    struct Node;
+
+public:
+    // An Iterator visits the elements of the set in ascending order.
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+    public:
+        // Initializes an Iterator that isn't positioned in any set.
+        Iterator();
+
+        const T& operator*() const;
+        const T* operator->() const;
+
+        Iterator& operator++();
+        Iterator operator++(int);
+
+        bool operator==(const Iterator& other) const;
+        bool operator!=(const Iterator& other) const;
+
+    private:
+        friend class SkipListSet;
+
+        explicit Iterator(const Node* node);
+
+        const Node* node;
+    };
+
 public:
     // Initializes an SkipListSet to be empty.
     SkipListSet();
@@ -136,77 +249,144 @@ public:
     // add() adds an element to the set.  If the element is already in the set,
     // this function has no effect.  This function runs in an expected time
     // of O(log n) (i.e., over the long run, we expect the average to be
-    // O(log n)) with very high probability.
+    // O(log n)) with very high probability.  It's lock-free: it may be called
+    // while other threads are adding to or searching the set.
     virtual void add(const T& element);
 
 
     // contains() returns true if the given element is already in the set,
     // false otherwise.  This function runs in an expected time of O(log n)
     // (i.e., over the long run, we expect the average to be O(log n))
-    // with very high probability.
+    // with very high probability.  It never waits for other threads.
     virtual bool contains(const T& element) const;
 
 
+    // containsView() is equivalent to contains(), but doesn't require the
+    // caller to build an element to look for.
+    virtual bool containsView(typename Set<T>::KeyView element) const;
+
+
     // size() returns the number of elements in the set.
     virtual unsigned int size() const;
 
 
+    // begin() and end() return Iterators positioned at the smallest element
+    // and just past the largest one.
+    Iterator begin() const;
+    Iterator end() const;
+
+
+    // lowerBound() returns an Iterator positioned at the smallest element
+    // that isn't less than the given one, or end() if there's no such
+    // element.  This function runs in an expected time of O(log n).
+    Iterator lowerBound(typename Set<T>::KeyView element) const;
+
+
+    // prefixRange() returns the range of the elements that begin with the
+    // given prefix, which is meaningful only for a set of strings.  This
+    // function runs in an expected time of O(log n), and visiting the k
+    // elements in the range takes O(k) more.
+    OrderedRange<Iterator> prefixRange(std::string_view prefix) const;
+
+
 private:
-/*    struct Node
+    struct Node
+    {
+        Node(const SkipListKey<T>* key, Node* next, Node* down);
+
+        const SkipListKey<T>* key;
+        std::atomic<Node*> next;
+        Node* down;
+    };
+
+    // A Leaf is a bottom-level node, which holds the key that it and every
+    // node above it point to.  The heads of the levels above the bottom
+    // point to the -INF key in heads[0].
+    struct Leaf : Node
     {
-        SkipListKey<T> info ;//(SkipListKind::NegInf, T()); //(SkipListKind kind,const T& key); 
-        Node* next=nullptr; 
-        Node* down=nullptr; 
-        int level=0; 
+        Leaf(const SkipListKey<T>& value, Node* next);
+
+        SkipListKey<T> value;
     };
-    vector<Node*> skip_list;  
-    int Node_size=0; 
-    random_device device_solver;
-    T maxkey= numeric_limits<T>::max(); 
-    T minkey= numeric_limits<T>::min(); 
-    void deleteall(std::vector<Node*> list);
-    void deletenode(Node* L);
-    int random_number(random_device device);*/
 
+    // heads[0] is the head of the bottom level, and each head's down
+    // pointer leads to the head of the level below it.  Every level ends
+    // at the same +INF node, tail.
+    Node* heads[MAX_LEVELS];
+    Node* tail;
+
+    // The highest level that has ever held an element; searches start
+    // there, since the levels above it are empty.
+    std::atomic<unsigned int> top_level;
+    std::atomic<unsigned int> element_count;
+
+
+private:
+    static unsigned int randomHeight();
+    static Node* skip(Node* node, typename Set<T>::KeyView element, Node*& next);
+
+    void createEmpty();
+    void destroyAll();
+    void swapAll(SkipListSet& s);
+    void copyAll(const SkipListSet& s);
 };
 
 
+
+template <typename T>
+SkipListSet<T>::Node::Node(const SkipListKey<T>* key, Node* next, Node* down)
+    : key{key}, next{next}, down{down}
+{
+}
+
+
+template <typename T>
+SkipListSet<T>::Leaf::Leaf(const SkipListKey<T>& value, Node* next)
+    : Node{&this->value, next, nullptr}, value{value}
+{
+}
+
+
 template <typename T>
 SkipListSet<T>::SkipListSet()
 {
-/*    Node* head= new Node(); 
-    Node* tail= new Node(); */
-   /* head->info(SkipListKind::PosInf,minkey);
-    tail->info(SkipListKind::NegInf,maxkey);
-    head->next=tail; 
-    head->level=0;  
-    tail->level=0;
-    skip_list[0]=head;*/
+    createEmpty();
 }
 
 
 template <typename T>
 SkipListSet<T>::~SkipListSet()
 {
-   // deleteall(skip_list);
+    destroyAll();
 }
 
 
 template <typename T>
 SkipListSet<T>::SkipListSet(const SkipListSet& s)
 {
+    createEmpty();
+    copyAll(s);
 }
 
 
 template <typename T>
 SkipListSet<T>::SkipListSet(SkipListSet&& s)
 {
+    createEmpty();
+    swapAll(s);
 }
 
 
 template <typename T>
 SkipListSet<T>& SkipListSet<T>::operator=(const SkipListSet& s)
 {
+    if (this != &s)
+    {
+        destroyAll();
+        createEmpty();
+        copyAll(s);
+    }
+
     return *this;
 }
 
@@ -214,6 +394,7 @@ SkipListSet<T>& SkipListSet<T>::operator=(const SkipListSet& s)
 template <typename T>
 SkipListSet<T>& SkipListSet<T>::operator=(SkipListSet&& s)
 {
+    swapAll(s);
     return *this;
 }
 
@@ -221,92 +402,360 @@ SkipListSet<T>& SkipListSet<T>::operator=(SkipListSet&& s)
 template <typename T>
 bool SkipListSet<T>::isImplemented() const
 {
-    return false;
+    return true;
 }
 
 
 template <typename T>
 void SkipListSet<T>::add(const T& element)
 {
-/*    if(!contains(element))
+    // First, find the node on each level after which the new element's
+    // node would go.
+    Node* predecessors[MAX_LEVELS];
+    unsigned int top = top_level.load(std::memory_order_acquire);
+    Node* node = heads[top];
+    Node* next;
+
+    for (unsigned int level = top; ; --level)
     {
-        for(Node* temp=skip_list[level];temp!=nullptr;temp=temp->next)
+        node = skip(node, element, next);
+        predecessors[level] = node;
+
+        if (level == 0)
         {
-            if(temp->info<SkipListKey(SkipListKind::Normal,element))
+            break;
+        }
+
+        node = node->down;
+    }
+
+    for (unsigned int level = top + 1; level < MAX_LEVELS; ++level)
+    {
+        predecessors[level] = heads[level];
+    }
+
+    // Then link the new nodes in, from the bottom up.  If another thread
+    // changes a predecessor's next pointer first, the search resumes from
+    // that predecessor, which is still in the right place, since nothing
+    // is ever removed.
+    unsigned int height = randomHeight();
+    Leaf* leaf = nullptr;
+    Node* below = nullptr;
+
+    for (unsigned int level = 0; level < height; ++level)
+    {
+        Node* added = nullptr;
+
+        while (true)
+        {
+            Node* successor;
+            Node* predecessor = skip(predecessors[level], element, successor);
+
+            if (level == 0 && successor->key->equals(element))
+            {
+                delete leaf;
+                return;
+            }
+
+            if (added == nullptr && level == 0)
+            {
+                leaf = new Leaf{SkipListKey<T>{SkipListKind::Normal, element}, successor};
+                added = leaf;
+            }
+            else if (added == nullptr)
+            {
+                added = new Node{&leaf->value, successor, below};
+            }
+            else
+            {
+                added->next.store(successor, std::memory_order_relaxed);
+            }
+
+            if (predecessor->next.compare_exchange_weak(
+                    successor, added, std::memory_order_release, std::memory_order_relaxed))
             {
-                Node* newnode= new node(); 
-                newnode->info=SkipListKey(SkipListKind::Normal,element);
-                newnode->next=temp->next; 
-                temp=newnode; 
-                if(random_number(device_solver)==1)
-                {
-                    skip_list[level+1]
-                }
+                break;
             }
+
+            predecessors[level] = predecessor;
+        }
+
+        if (level == 0)
+        {
+            element_count.fetch_add(1, std::memory_order_relaxed);
         }
-    }*/
+
+        below = added;
+    }
+
+    while (top < height - 1
+        && !top_level.compare_exchange_weak(top, height - 1, std::memory_order_release))
+    {
+    }
 }
 
 
 template <typename T>
 bool SkipListSet<T>::contains(const T& element) const
 {
-/*  //  for(int i=skip_list.size();i>=0;i--)
-  //  {
-        while(skip_list[i]!=nullptr)
+    return SkipListSet<T>::containsView(element);
+}
+
+
+template <typename T>
+bool SkipListSet<T>::containsView(typename Set<T>::KeyView element) const
+{
+    Node* node = heads[top_level.load(std::memory_order_acquire)];
+    Node* next;
+
+    while (true)
+    {
+        node = skip(node, element, next);
+
+        if (next->key->equals(element))
         {
-            if(skip_list[i]->info==SkipListKey<T>(SkipListKind::Normal,element))
-            {
-                return true; 
-            }
-            else if(element<SkipListKey<T>(SkipListKind::Normal,element))
-            {
-                skip_list=skip_list->down; 
-            }
-            else
-                skip_list=skip_list->next; 
+            return true;
+        }
+        else if (node->down == nullptr)
+        {
+            return false;
         }
-   // }
-    return false;*/
-    return false; 
+
+        node = node->down;
+    }
 }
 
 
 template <typename T>
 unsigned int SkipListSet<T>::size() const
 {
-    return 0; 
-    //return Node_size;
+    return element_count.load(std::memory_order_relaxed);
 }
 
-/*template<typename T>
-void SkipListSet<T>:: deleteall(std::vector<Node*> list)
+
+template <typename T>
+typename SkipListSet<T>::Iterator SkipListSet<T>::begin() const
+{
+    return Iterator{heads[0]->next.load(std::memory_order_acquire)};
+}
+
+
+template <typename T>
+typename SkipListSet<T>::Iterator SkipListSet<T>::end() const
+{
+    return Iterator{tail};
+}
+
+
+template <typename T>
+typename SkipListSet<T>::Iterator SkipListSet<T>::lowerBound(typename Set<T>::KeyView element) const
 {
-    for( int i=list.size(); i>=0; i--)
+    Node* node = heads[top_level.load(std::memory_order_acquire)];
+    Node* next;
+
+    while (true)
     {
-        deletenode(list[i]);
+        node = skip(node, element, next);
+
+        if (node->down == nullptr)
+        {
+            return Iterator{next};
+        }
+
+        node = node->down;
     }
-   // delete list; 
-}*/
+}
+
+
+template <typename T>
+OrderedRange<typename SkipListSet<T>::Iterator> SkipListSet<T>::prefixRange(std::string_view prefix) const
+{
+    return makePrefixRange(*this, prefix);
+}
+
+
+template <typename T>
+SkipListSet<T>::Iterator::Iterator()
+    : node{nullptr}
+{
+}
+
+
+template <typename T>
+SkipListSet<T>::Iterator::Iterator(const Node* node)
+    : node{node}
+{
+}
+
+
+template <typename T>
+const T& SkipListSet<T>::Iterator::operator*() const
+{
+    return node->key->element();
+}
+
+
+template <typename T>
+const T* SkipListSet<T>::Iterator::operator->() const
+{
+    return &node->key->element();
+}
+
 
-/*template<typename T>
-void SkipListSet<T>:: deletenode(Node* L)
+template <typename T>
+typename SkipListSet<T>::Iterator& SkipListSet<T>::Iterator::operator++()
 {
-    if(L!=nullptr)
+    node = node->next.load(std::memory_order_acquire);
+    return *this;
+}
+
+
+template <typename T>
+typename SkipListSet<T>::Iterator SkipListSet<T>::Iterator::operator++(int)
+{
+    Iterator previous = *this;
+    ++*this;
+    return previous;
+}
+
+
+template <typename T>
+bool SkipListSet<T>::Iterator::operator==(const Iterator& other) const
+{
+    return node == other.node;
+}
+
+
+template <typename T>
+bool SkipListSet<T>::Iterator::operator!=(const Iterator& other) const
+{
+    return node != other.node;
+}
+
+
+// randomHeight() returns the number of levels that a new element will
+// appear on: one, plus one more for each coin flip that comes up heads
+// before the first one that comes up tails.  Each thread has its own
+// random number engine, so threads don't contend for one.
+template <typename T>
+unsigned int SkipListSet<T>::randomHeight()
+{
+    static thread_local std::mt19937 engine{std::random_device{}()};
+
+    unsigned int flips = static_cast<unsigned int>(engine());
+    unsigned int height = 1;
+
+    while ((flips & 1) != 0 && height < MAX_LEVELS)
     {
-        deletenode(L->next);
-        delete L; 
+        flips >>= 1;
+        ++height;
     }
+
+    return height;
 }
 
-template<typename T>
-int SkipListSet<T>:: random_number(random_device device)
+
+// skip() moves forward along a level from the given node, as far as it can
+// without passing any node whose key isn't less than the given element.
+// It returns the node it stopped at, and stores the node that followed it
+// at that moment into its last parameter.  (Reloading the next pointer
+// afterward would be a mistake, since another thread may have inserted a
+// smaller key after the returned node in the meantime.)
+template <typename T>
+typename SkipListSet<T>::Node* SkipListSet<T>::skip(
+    Node* node, typename Set<T>::KeyView element, Node*& next)
 {
-    default_random_engine engine{device()}; 
-    uniform_int_distribution<int> dis{0,1}; 
-    int number=dis(engine); 
-    return number; 
-}*/
+    next = node->next.load(std::memory_order_acquire);
+
+    while (next->key->lessThan(element))
+    {
+        node = next;
+        next = node->next.load(std::memory_order_acquire);
+    }
+
+    return node;
+}
 
-#endif // SKIPLISTSET_HPP
 
+template <typename T>
+void SkipListSet<T>::createEmpty()
+{
+    tail = new Leaf{SkipListKey<T>{SkipListKind::PosInf, T{}}, nullptr};
+    heads[0] = new Leaf{SkipListKey<T>{SkipListKind::NegInf, T{}}, tail};
+
+    for (unsigned int level = 1; level < MAX_LEVELS; ++level)
+    {
+        heads[level] = new Node{heads[0]->key, tail, heads[level - 1]};
+    }
+
+    top_level.store(0, std::memory_order_relaxed);
+    element_count.store(0, std::memory_order_relaxed);
+}
+
+
+// destroyAll() frees the levels from the top down, so that no key is freed
+// while a node above it still points to it.  The bottom level's nodes are
+// all Leaves.
+template <typename T>
+void SkipListSet<T>::destroyAll()
+{
+    for (unsigned int level = MAX_LEVELS; level-- > 0; )
+    {
+        Node* node = heads[level];
+
+        while (node != tail)
+        {
+            Node* next = node->next.load(std::memory_order_relaxed);
+
+            if (level == 0)
+            {
+                delete static_cast<Leaf*>(node);
+            }
+            else
+            {
+                delete node;
+            }
+
+            node = next;
+        }
+    }
+
+    delete static_cast<Leaf*>(tail);
+}
+
+
+template <typename T>
+void SkipListSet<T>::swapAll(SkipListSet& s)
+{
+    for (unsigned int level = 0; level < MAX_LEVELS; ++level)
+    {
+        std::swap(heads[level], s.heads[level]);
+    }
+
+    std::swap(tail, s.tail);
+
+    top_level.store(
+        s.top_level.exchange(top_level.load(std::memory_order_relaxed)),
+        std::memory_order_relaxed);
+
+    element_count.store(
+        s.element_count.exchange(element_count.load(std::memory_order_relaxed)),
+        std::memory_order_relaxed);
+}
+
+
+template <typename T>
+void SkipListSet<T>::copyAll(const SkipListSet& s)
+{
+    Node* node = s.heads[0]->next.load(std::memory_order_acquire);
+
+    while (node != s.tail)
+    {
+        add(node->key->element());
+        node = node->next.load(std::memory_order_acquire);
+    }
+}
+
+
+
+#endif // SKIPLISTSET_HPP
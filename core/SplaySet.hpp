@@ -0,0 +1,370 @@
+// SplaySet.hpp
+//
+// ICS 46 Spring 2017
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A SplaySet is an implementation of a Set that is a splay tree.  It makes
+// no attempt to stay balanced; instead, every search "splays" the element
+// it was looking for (or the last node it reached) up to the root, with a
+// series of rotations that also roughly halves the depth of every node
+// along the way.  Any sequence of operations takes O(log n) amortized time
+// per operation, but elements that are searched for often stay near the
+// root, so a skewed workload does much better than that: the amortized
+// cost of finding an element is proportional to the log of the inverse of
+// how often it's searched for.  Natural-language text is very skewed --
+// words like "THE" and "OF" make up a large share of any text -- so most
+// lookups made while checking it end within a few levels of the root.
+//
+// The splaying is done top-down, in a single pass: as the search descends,
+// the nodes it passes are split off into a tree of smaller elements and a
+// tree of larger ones, which are reassembled under the final node as the
+// new root's left and right subtrees.
+//
+// Since searching reshapes the tree, contains() modifies it, even though
+// it doesn't change what's in the set.
+
+#ifndef SPLAYSET_HPP
+#define SPLAYSET_HPP
+
+#include <algorithm>
+#include <utility>
+#include "NodePool.hpp"
+#include "Set.hpp"
+
+
+
+template <typename T>
+class SplaySet : public Set<T>
+{
+public:
+    // Initializes a SplaySet to be empty.
+    SplaySet();
+
+    // Cleans up the SplaySet so that it leaks no memory.
+    virtual ~SplaySet();
+
+    // Initializes a new SplaySet to be a copy of an existing one.
+    SplaySet(const SplaySet& s);
+
+    // Initializes a new SplaySet whose contents are moved from an
+    // expiring one.
+    SplaySet(SplaySet&& s);
+
+    // Assigns an existing SplaySet into another.
+    SplaySet& operator=(const SplaySet& s);
+
+    // Assigns an expiring SplaySet into another.
+    SplaySet& operator=(SplaySet&& s);
+
+
+    virtual bool isImplemented() const;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  Either way, the element ends up at
+    // the root.  This function runs in O(log n) amortized time.
+    virtual void add(const T& element);
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise, and splays the element (or its nearest neighbor) to
+    // the root.  This function runs in O(log n) amortized time, and less
+    // for elements that are searched for often.
+    virtual bool contains(const T& element) const;
+
+
+    // containsView() is equivalent to contains(), but doesn't require the
+    // caller to build an element to look for.
+    virtual bool containsView(typename Set<T>::KeyView element) const;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const;
+
+
+    // reserve() sets aside room in the node pool for the given number of
+    // nodes, so that they can be allocated contiguously.
+    virtual void reserve(unsigned int count);
+
+
+private:
+    struct Node
+    {
+        T key;
+        Node* left = nullptr;
+        Node* right = nullptr;
+    };
+
+    NodePool<Node> pool;
+    mutable Node* root;
+    unsigned int tree_size;
+
+
+private:
+    static Node* splay(typename Set<T>::KeyView element, Node* node);
+    void copyAll(const SplaySet& s);
+};
+
+
+
+template <typename T>
+SplaySet<T>::SplaySet()
+    : root{nullptr}, tree_size{0}
+{
+}
+
+
+template <typename T>
+SplaySet<T>::~SplaySet()
+{
+}
+
+
+template <typename T>
+SplaySet<T>::SplaySet(const SplaySet& s)
+    : root{nullptr}, tree_size{0}
+{
+    copyAll(s);
+}
+
+
+template <typename T>
+SplaySet<T>::SplaySet(SplaySet&& s)
+    : root{nullptr}, tree_size{0}
+{
+    pool.swap(s.pool);
+    std::swap(root, s.root);
+    std::swap(tree_size, s.tree_size);
+}
+
+
+template <typename T>
+SplaySet<T>& SplaySet<T>::operator=(const SplaySet& s)
+{
+    if (this != &s)
+    {
+        pool.clear();
+        root = nullptr;
+        tree_size = 0;
+        copyAll(s);
+    }
+
+    return *this;
+}
+
+
+template <typename T>
+SplaySet<T>& SplaySet<T>::operator=(SplaySet&& s)
+{
+    pool.swap(s.pool);
+    std::swap(root, s.root);
+    std::swap(tree_size, s.tree_size);
+    return *this;
+}
+
+
+template <typename T>
+bool SplaySet<T>::isImplemented() const
+{
+    return true;
+}
+
+
+template <typename T>
+void SplaySet<T>::add(const T& element)
+{
+    if (root != nullptr)
+    {
+        root = splay(element, root);
+
+        if (!(element < root->key) && !(root->key < element))
+        {
+            return;
+        }
+    }
+
+    Node* node = pool.create();
+    node->key = element;
+
+    // The old root is the new element's nearest neighbor, so the new
+    // element can take its place, with the old root on one side of it.
+    if (root != nullptr && element < root->key)
+    {
+        node->left = root->left;
+        node->right = root;
+        root->left = nullptr;
+    }
+    else if (root != nullptr)
+    {
+        node->right = root->right;
+        node->left = root;
+        root->right = nullptr;
+    }
+
+    root = node;
+    ++tree_size;
+}
+
+
+template <typename T>
+bool SplaySet<T>::contains(const T& element) const
+{
+    return SplaySet<T>::containsView(element);
+}
+
+
+template <typename T>
+bool SplaySet<T>::containsView(typename Set<T>::KeyView element) const
+{
+    if (root == nullptr)
+    {
+        return false;
+    }
+
+    root = splay(element, root);
+    return !(element < root->key) && !(root->key < element);
+}
+
+
+template <typename T>
+unsigned int SplaySet<T>::size() const
+{
+    return tree_size;
+}
+
+
+template <typename T>
+void SplaySet<T>::reserve(unsigned int count)
+{
+    if (count > tree_size)
+    {
+        pool.reserve(count - tree_size);
+    }
+}
+
+
+// splay() splays the given element, or the last node on the path to where
+// it would be, to the root of the subtree rooted at the given node, and
+// returns the new root.  leftHook and rightHook are where the next nodes
+// split off into the trees of smaller and larger elements will be linked.
+template <typename T>
+typename SplaySet<T>::Node* SplaySet<T>::splay(typename Set<T>::KeyView element, Node* node)
+{
+    Node* smaller = nullptr;
+    Node** leftHook = &smaller;
+    Node* larger = nullptr;
+    Node** rightHook = &larger;
+
+    while (true)
+    {
+        if (element < node->key)
+        {
+            if (node->left == nullptr)
+            {
+                break;
+            }
+
+            if (element < node->left->key)
+            {
+                // Zig-zig: rotate right before splitting the node off.
+                Node* left = node->left;
+                node->left = left->right;
+                left->right = node;
+                node = left;
+
+                if (node->left == nullptr)
+                {
+                    break;
+                }
+            }
+
+            *rightHook = node;
+            rightHook = &node->left;
+            node = node->left;
+        }
+        else if (node->key < element)
+        {
+            if (node->right == nullptr)
+            {
+                break;
+            }
+
+            if (node->right->key < element)
+            {
+                // Zag-zag: rotate left before splitting the node off.
+                Node* right = node->right;
+                node->right = right->left;
+                right->left = node;
+                node = right;
+
+                if (node->right == nullptr)
+                {
+                    break;
+                }
+            }
+
+            *leftHook = node;
+            leftHook = &node->right;
+            node = node->right;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    *leftHook = node->left;
+    *rightHook = node->right;
+    node->left = smaller;
+    node->right = larger;
+    return node;
+}
+
+
+// copyAll() copies the elements in order into a chain of right children,
+// which is as legitimate a splay tree as any; the first few searches of
+// the copy will shape it.  A splay tree can be arbitrarily deep, so the
+// stack used to walk the original lives on the heap and grows as needed.
+template <typename T>
+void SplaySet<T>::copyAll(const SplaySet& s)
+{
+    unsigned int capacity = 64;
+    Node** stack = new Node*[capacity];
+    unsigned int depth = 0;
+
+    Node** tail = &root;
+
+    for (Node* node = s.root; node != nullptr || depth > 0; )
+    {
+        while (node != nullptr)
+        {
+            if (depth == capacity)
+            {
+                Node** bigger = new Node*[capacity * 2];
+                std::copy(stack, stack + capacity, bigger);
+                delete[] stack;
+                stack = bigger;
+                capacity *= 2;
+            }
+
+            stack[depth++] = node;
+            node = node->left;
+        }
+
+        node = stack[--depth];
+
+        Node* copy = pool.create();
+        copy->key = node->key;
+        *tail = copy;
+        tail = &copy->right;
+
+        node = node->right;
+    }
+
+    delete[] stack;
+    tree_size = s.tree_size;
+}
+
+
+
+#endif // SPLAYSET_HPP
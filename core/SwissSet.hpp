@@ -0,0 +1,434 @@
+// SwissSet.hpp
+//
+// ICS 46 Spring 2017
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A SwissSet is an implementation of a Set that is an open-addressed hash
+// table in the style of a "Swiss table".  Alongside its array of keys, it
+// keeps an array of one-byte control values, one per slot: a control value
+// is either EMPTY or the low seven bits of the hash of the key stored in
+// that slot (its "fingerprint").
+//
+// The slots are divided into groups of GROUP_WIDTH adjacent slots.  A
+// lookup compares the fingerprint it's searching for against the control
+// bytes of a whole group at once -- using SSE2 (16 slots) or AVX2 (32 slots)
+// instructions where the compiler makes them available, and a plain loop
+// elsewhere -- and only compares keys in the slots whose fingerprints
+// match, which is almost never more than the one that holds the key being
+// sought.  Groups are probed in a triangular sequence until one is found
+// that has an empty slot in it.
+//
+// The table holds a power-of-two number of groups, and the number of groups
+// doubles whenever the ratio of size to capacity would exceed 7/8.
+
+#ifndef SWISSSET_HPP
+#define SWISSSET_HPP
+
+#include <functional>
+#include <utility>
+#include "FunctionHasher.hpp"
+#include "Set.hpp"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+
+
+template <typename T, typename Hasher = FunctionHasher<T>>
+class SwissSet : public Set<T>
+{
+public:
+    // The number of adjacent slots whose control bytes are examined at once.
+#if defined(__AVX2__)
+    static constexpr unsigned int GROUP_WIDTH = 32;
+#else
+    static constexpr unsigned int GROUP_WIDTH = 16;
+#endif
+
+    // The default number of groups in the SwissSet before anything has
+    // been added to it.  This must be a power of two.
+    static constexpr unsigned int DEFAULT_GROUPS = 1;
+
+    // A HashFunction
+    typedef typename FunctionHasher<T>::HashFunction HashFunction;
+
+public:
+    // Initializes a SwissSet to be empty, so that it will use the given
+    // hasher whenever it needs to hash an element.  (With the default
+    // Hasher, this can be any hash function.)
+    SwissSet(Hasher hashFunction = Hasher{});
+
+    // Cleans up the SwissSet so that it leaks no memory.
+    virtual ~SwissSet();
+
+    // Initializes a new SwissSet to be a copy of an existing one.
+    SwissSet(const SwissSet& s);
+
+    // Initializes a new SwissSet whose contents are moved from an
+    // expiring one.
+    SwissSet(SwissSet&& s);
+
+    // Assigns an existing SwissSet into another.
+    SwissSet& operator=(const SwissSet& s);
+
+    // Assigns an expiring SwissSet into another.
+    SwissSet& operator=(SwissSet&& s);
+
+
+    virtual bool isImplemented() const;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  This function runs in linear time
+    // when the table is grown and in expected constant time otherwise.
+    virtual void add(const T& element);
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  This function runs in expected constant time, and
+    // usually compares at most one key.
+    virtual bool contains(const T& element) const;
+
+
+    // containsView() is equivalent to contains(), but doesn't require the
+    // caller to build an element to look for.
+    virtual bool containsView(typename Set<T>::KeyView element) const;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const;
+
+
+    // reserve() grows the table, if necessary, so that it can hold the
+    // given number of elements without growing again.
+    virtual void reserve(unsigned int count);
+
+
+private:
+    // The control value of a slot that holds no key.  Any full slot has a
+    // control value between 0 and 127, so the high bit tells them apart.
+    static constexpr signed char EMPTY = -128;
+
+    Hasher hashFunction;
+    signed char* control;
+    T* keys;
+    unsigned int table_size;
+    unsigned int group_count;
+
+
+private:
+    static unsigned int mix(unsigned int hash);
+    static unsigned int lowestBit(unsigned int mask);
+    static unsigned int match(const signed char* group, signed char value);
+
+    bool find(typename Set<T>::KeyView element, unsigned int hash) const;
+    void place(T key, unsigned int hash);
+    void rehash(unsigned int groups);
+    void allocate(unsigned int groups);
+    void copyAll(const SwissSet& s);
+};
+
+
+
+template <typename T, typename Hasher>
+SwissSet<T, Hasher>::SwissSet(Hasher hashFunction)
+    : hashFunction{hashFunction}
+{
+    allocate(DEFAULT_GROUPS);
+}
+
+
+template <typename T, typename Hasher>
+SwissSet<T, Hasher>::~SwissSet()
+{
+    delete[] control;
+    delete[] keys;
+}
+
+
+template <typename T, typename Hasher>
+SwissSet<T, Hasher>::SwissSet(const SwissSet& s)
+    : hashFunction{s.hashFunction}
+{
+    copyAll(s);
+}
+
+
+template <typename T, typename Hasher>
+SwissSet<T, Hasher>::SwissSet(SwissSet&& s)
+    : hashFunction{s.hashFunction}
+{
+    allocate(DEFAULT_GROUPS);
+    std::swap(control, s.control);
+    std::swap(keys, s.keys);
+    std::swap(table_size, s.table_size);
+    std::swap(group_count, s.group_count);
+}
+
+
+template <typename T, typename Hasher>
+SwissSet<T, Hasher>& SwissSet<T, Hasher>::operator=(const SwissSet& s)
+{
+    if (this != &s)
+    {
+        delete[] control;
+        delete[] keys;
+        hashFunction = s.hashFunction;
+        copyAll(s);
+    }
+
+    return *this;
+}
+
+
+template <typename T, typename Hasher>
+SwissSet<T, Hasher>& SwissSet<T, Hasher>::operator=(SwissSet&& s)
+{
+    std::swap(hashFunction, s.hashFunction);
+    std::swap(control, s.control);
+    std::swap(keys, s.keys);
+    std::swap(table_size, s.table_size);
+    std::swap(group_count, s.group_count);
+    return *this;
+}
+
+
+template <typename T, typename Hasher>
+bool SwissSet<T, Hasher>::isImplemented() const
+{
+    return true;
+}
+
+
+template <typename T, typename Hasher>
+void SwissSet<T, Hasher>::add(const T& element)
+{
+    unsigned int hash = mix(hashFunction(element));
+
+    if (find(element, hash))
+    {
+        return;
+    }
+
+    if ((table_size + 1) * 8 > group_count * GROUP_WIDTH * 7)
+    {
+        rehash(group_count * 2);
+    }
+
+    place(element, hash);
+    ++table_size;
+}
+
+
+template <typename T, typename Hasher>
+bool SwissSet<T, Hasher>::contains(const T& element) const
+{
+    return find(element, mix(hashFunction(element)));
+}
+
+
+template <typename T, typename Hasher>
+bool SwissSet<T, Hasher>::containsView(typename Set<T>::KeyView element) const
+{
+    return find(element, mix(hashFunction(element)));
+}
+
+
+template <typename T, typename Hasher>
+unsigned int SwissSet<T, Hasher>::size() const
+{
+    return table_size;
+}
+
+
+template <typename T, typename Hasher>
+void SwissSet<T, Hasher>::reserve(unsigned int count)
+{
+    unsigned int groups = group_count;
+
+    while (count * 8 > groups * GROUP_WIDTH * 7)
+    {
+        groups *= 2;
+    }
+
+    if (groups > group_count)
+    {
+        rehash(groups);
+    }
+}
+
+
+template <typename T, typename Hasher>
+unsigned int SwissSet<T, Hasher>::mix(unsigned int hash)
+{
+    // The fingerprint and the group index are taken from different bits
+    // of the hash, so every bit needs to depend on every input bit.
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+
+template <typename T, typename Hasher>
+unsigned int SwissSet<T, Hasher>::lowestBit(unsigned int mask)
+{
+#if defined(__GNUC__)
+    return static_cast<unsigned int>(__builtin_ctz(mask));
+#else
+    unsigned int bit = 0;
+
+    while ((mask & 1) == 0)
+    {
+        mask >>= 1;
+        ++bit;
+    }
+
+    return bit;
+#endif
+}
+
+
+template <typename T, typename Hasher>
+unsigned int SwissSet<T, Hasher>::match(const signed char* group, signed char value)
+{
+#if defined(__AVX2__)
+    __m256i controls = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(group));
+    __m256i matches = _mm256_cmpeq_epi8(controls, _mm256_set1_epi8(value));
+    return static_cast<unsigned int>(_mm256_movemask_epi8(matches));
+#elif defined(__SSE2__)
+    __m128i controls = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    __m128i matches = _mm_cmpeq_epi8(controls, _mm_set1_epi8(value));
+    return static_cast<unsigned int>(_mm_movemask_epi8(matches));
+#else
+    unsigned int mask = 0;
+
+    for (unsigned int i = 0; i < GROUP_WIDTH; ++i)
+    {
+        if (group[i] == value)
+        {
+            mask |= 1u << i;
+        }
+    }
+
+    return mask;
+#endif
+}
+
+
+template <typename T, typename Hasher>
+bool SwissSet<T, Hasher>::find(typename Set<T>::KeyView element, unsigned int hash) const
+{
+    signed char fingerprint = static_cast<signed char>(hash & 0x7f);
+    unsigned int groupMask = group_count - 1;
+    unsigned int group = (hash >> 7) & groupMask;
+
+    for (unsigned int step = 1; ; ++step)
+    {
+        const signed char* controls = control + group * GROUP_WIDTH;
+
+        for (unsigned int mask = match(controls, fingerprint); mask != 0; mask &= mask - 1)
+        {
+            if (keys[group * GROUP_WIDTH + lowestBit(mask)] == element)
+            {
+                return true;
+            }
+        }
+
+        if (match(controls, EMPTY) != 0 || step > group_count)
+        {
+            return false;
+        }
+
+        group = (group + step) & groupMask;
+    }
+}
+
+
+template <typename T, typename Hasher>
+void SwissSet<T, Hasher>::place(T key, unsigned int hash)
+{
+    unsigned int groupMask = group_count - 1;
+    unsigned int group = (hash >> 7) & groupMask;
+
+    for (unsigned int step = 1; ; ++step)
+    {
+        unsigned int empty = match(control + group * GROUP_WIDTH, EMPTY);
+
+        if (empty != 0)
+        {
+            unsigned int slot = group * GROUP_WIDTH + lowestBit(empty);
+            control[slot] = static_cast<signed char>(hash & 0x7f);
+            keys[slot] = std::move(key);
+            return;
+        }
+
+        group = (group + step) & groupMask;
+    }
+}
+
+
+template <typename T, typename Hasher>
+void SwissSet<T, Hasher>::rehash(unsigned int groups)
+{
+    signed char* oldControl = control;
+    T* oldKeys = keys;
+    unsigned int oldCapacity = group_count * GROUP_WIDTH;
+
+    allocate(groups);
+
+    for (unsigned int i = 0; i < oldCapacity; ++i)
+    {
+        if (oldControl[i] != EMPTY)
+        {
+            unsigned int hash = mix(hashFunction(oldKeys[i]));
+            place(std::move(oldKeys[i]), hash);
+            ++table_size;
+        }
+    }
+
+    delete[] oldControl;
+    delete[] oldKeys;
+}
+
+
+template <typename T, typename Hasher>
+void SwissSet<T, Hasher>::allocate(unsigned int groups)
+{
+    unsigned int capacity = groups * GROUP_WIDTH;
+
+    control = new signed char[capacity];
+    keys = new T[capacity];
+    table_size = 0;
+    group_count = groups;
+
+    for (unsigned int i = 0; i < capacity; ++i)
+    {
+        control[i] = EMPTY;
+    }
+}
+
+
+template <typename T, typename Hasher>
+void SwissSet<T, Hasher>::copyAll(const SwissSet& s)
+{
+    unsigned int capacity = s.group_count * GROUP_WIDTH;
+
+    control = new signed char[capacity];
+    keys = new T[capacity];
+    table_size = s.table_size;
+    group_count = s.group_count;
+
+    for (unsigned int i = 0; i < capacity; ++i)
+    {
+        control[i] = s.control[i];
+        keys[i] = s.keys[i];
+    }
+}
+
+
+
+#endif // SWISSSET_HPP
@@ -0,0 +1,421 @@
+// VebSet.hpp
+//
+// ICS 46 Spring 2017
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A VebSet is an implementation of a Set meant for dictionaries that are
+// built once and then only searched.  Elements are collected in an AVLSet
+// while they're being added; when the set is frozen, they're copied out of
+// the tree, in order, into a single array that holds a perfectly balanced
+// binary search tree stored in the "van Emde Boas layout".  There are no
+// pointers in the array; the positions of a node's children are computed
+// as the search descends.
+//
+// The van Emde Boas layout is defined recursively.  A tree of height h is
+// cut at half its height into a "top" tree and the "bottom" trees hanging
+// below it; the top tree is laid out first, followed by each of the bottom
+// trees in order, each of them laid out the same way.  Whatever the size of
+// a cache line (or a page), a search therefore touches only O(log_B n)
+// blocks of B elements, without the layout having to know what B is.
+//
+// The position of a node is found with the method of Brodal, Fagerberg and
+// Jacob.  Every depth d below the root is the depth of the bottom trees'
+// roots in exactly one of the recursive cuts; for that cut, top_size[d] is
+// the number of nodes in the top tree, bottom_size[d] is the number of
+// nodes in each bottom tree, and top_depth[d] is the depth of the top
+// tree's root.  A node at depth d whose breadth-first index is i then lives
+// at position
+//
+//     pos[top_depth[d]] + top_size[d] + (i & top_size[d]) * bottom_size[d]
+//
+// where pos[] holds the positions of the nodes already visited on the way
+// down from the root.
+//
+// The tree always has 2^h - 1 slots for some h.  Slots beyond the last
+// element are filled with copies of the largest element, which keeps the
+// search order intact without any special cases in the search loop.
+
+#ifndef VEBSET_HPP
+#define VEBSET_HPP
+
+#include <utility>
+#include "AVLSet.hpp"
+#include "Set.hpp"
+
+
+
+template <typename T>
+class VebSet : public Set<T>
+{
+public:
+    // The greatest height of a frozen tree, which is enough for any number
+    // of elements that an unsigned int can count.
+    static constexpr unsigned int MAX_HEIGHT = 32;
+
+public:
+    // Initializes a VebSet to be empty.
+    VebSet();
+
+    // Cleans up the VebSet so that it leaks no memory.
+    virtual ~VebSet();
+
+    // Initializes a new VebSet to be a copy of an existing one.
+    VebSet(const VebSet& s);
+
+    // Initializes a new VebSet whose contents are moved from an
+    // expiring one.
+    VebSet(VebSet&& s);
+
+    // Assigns an existing VebSet into another.
+    VebSet& operator=(const VebSet& s);
+
+    // Assigns an expiring VebSet into another.
+    VebSet& operator=(VebSet&& s);
+
+
+    virtual bool isImplemented() const;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  This function runs in O(log n)
+    // time, unless the set is frozen, in which case it first has to move
+    // every element back into the AVL tree, which takes O(n log n) time.
+    virtual void add(const T& element);
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  This function runs in O(log n) time.
+    virtual bool contains(const T& element) const;
+
+
+    // containsView() is equivalent to contains(), but doesn't require the
+    // caller to build an element to look for.
+    virtual bool containsView(typename Set<T>::KeyView element) const;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const;
+
+
+    // reserve() sets aside room in the AVL tree for the given number of
+    // elements.
+    virtual void reserve(unsigned int count);
+
+
+    // freeze() moves the elements out of the AVL tree and into the van
+    // Emde Boas layout.  This function runs in O(n) time.
+    virtual void freeze();
+
+
+private:
+    AVLSet<T> pending;
+
+    // The frozen tree, or nullptr if the set isn't frozen.
+    T* tree;
+    unsigned int tree_size;
+    unsigned int tree_height;
+
+    unsigned int top_size[MAX_HEIGHT] = {};
+    unsigned int bottom_size[MAX_HEIGHT] = {};
+    unsigned int top_depth[MAX_HEIGHT] = {};
+
+
+private:
+    unsigned int positionOf(unsigned int index, unsigned int depth, const unsigned int* pos) const;
+    void layOut(unsigned int top, unsigned int height);
+    void fill(
+        unsigned int index, unsigned int depth, unsigned int* pos,
+        const T* sorted, unsigned int& next);
+    void thaw();
+    void copyAll(const VebSet& s);
+};
+
+
+
+template <typename T>
+VebSet<T>::VebSet()
+    : tree{nullptr}, tree_size{0}, tree_height{0}
+{
+}
+
+
+template <typename T>
+VebSet<T>::~VebSet()
+{
+    delete[] tree;
+}
+
+
+template <typename T>
+VebSet<T>::VebSet(const VebSet& s)
+    : pending{s.pending}
+{
+    copyAll(s);
+}
+
+
+template <typename T>
+VebSet<T>::VebSet(VebSet&& s)
+    : tree{nullptr}, tree_size{0}, tree_height{0}
+{
+    *this = std::move(s);
+}
+
+
+template <typename T>
+VebSet<T>& VebSet<T>::operator=(const VebSet& s)
+{
+    if (this != &s)
+    {
+        delete[] tree;
+        pending = s.pending;
+        copyAll(s);
+    }
+
+    return *this;
+}
+
+
+template <typename T>
+VebSet<T>& VebSet<T>::operator=(VebSet&& s)
+{
+    std::swap(pending, s.pending);
+    std::swap(tree, s.tree);
+    std::swap(tree_size, s.tree_size);
+    std::swap(tree_height, s.tree_height);
+    std::swap(top_size, s.top_size);
+    std::swap(bottom_size, s.bottom_size);
+    std::swap(top_depth, s.top_depth);
+    return *this;
+}
+
+
+template <typename T>
+bool VebSet<T>::isImplemented() const
+{
+    return true;
+}
+
+
+template <typename T>
+void VebSet<T>::add(const T& element)
+{
+    if (tree != nullptr)
+    {
+        if (contains(element))
+        {
+            return;
+        }
+
+        thaw();
+    }
+
+    pending.add(element);
+}
+
+
+template <typename T>
+bool VebSet<T>::contains(const T& element) const
+{
+    return VebSet<T>::containsView(element);
+}
+
+
+template <typename T>
+bool VebSet<T>::containsView(typename Set<T>::KeyView element) const
+{
+    if (tree == nullptr)
+    {
+        return pending.containsView(element);
+    }
+
+    unsigned int pos[MAX_HEIGHT];
+    pos[0] = 0;
+
+    unsigned int index = 1;
+
+    for (unsigned int depth = 0; ; )
+    {
+        const T& key = tree[pos[depth]];
+
+        if (element < key)
+        {
+            index = 2 * index;
+        }
+        else if (key < element)
+        {
+            index = 2 * index + 1;
+        }
+        else
+        {
+            return true;
+        }
+
+        if (++depth == tree_height)
+        {
+            return false;
+        }
+
+        pos[depth] = positionOf(index, depth, pos);
+    }
+}
+
+
+template <typename T>
+unsigned int VebSet<T>::size() const
+{
+    return tree != nullptr ? tree_size : pending.size();
+}
+
+
+template <typename T>
+void VebSet<T>::reserve(unsigned int count)
+{
+    pending.reserve(count);
+}
+
+
+template <typename T>
+void VebSet<T>::freeze()
+{
+    if (tree != nullptr || pending.size() == 0)
+    {
+        return;
+    }
+
+    tree_size = pending.size();
+    tree_height = 0;
+
+    while (tree_height < MAX_HEIGHT && (1u << tree_height) - 1 < tree_size)
+    {
+        ++tree_height;
+    }
+
+    unsigned int slots = static_cast<unsigned int>((1ull << tree_height) - 1);
+
+    T* sorted = new T[tree_size];
+    unsigned int next = 0;
+
+    pending.forEachInOrder(
+        [&](const T& key)
+        {
+            sorted[next++] = key;
+        });
+
+    layOut(0, tree_height);
+
+    tree = new T[slots];
+
+    unsigned int pos[MAX_HEIGHT];
+    pos[0] = 0;
+    next = 0;
+    fill(1, 0, pos, sorted, next);
+
+    delete[] sorted;
+    pending = AVLSet<T>{};
+}
+
+
+template <typename T>
+unsigned int VebSet<T>::positionOf(
+    unsigned int index, unsigned int depth, const unsigned int* pos) const
+{
+    return pos[top_depth[depth]] + top_size[depth]
+        + (index & top_size[depth]) * bottom_size[depth];
+}
+
+
+template <typename T>
+void VebSet<T>::layOut(unsigned int top, unsigned int height)
+{
+    if (height <= 1)
+    {
+        return;
+    }
+
+    unsigned int topHeight = height / 2;
+    unsigned int bottomHeight = height - topHeight;
+    unsigned int cut = top + topHeight;
+
+    top_size[cut] = (1u << topHeight) - 1;
+    bottom_size[cut] = (1u << bottomHeight) - 1;
+    top_depth[cut] = top;
+
+    layOut(top, topHeight);
+    layOut(cut, bottomHeight);
+}
+
+
+// fill() walks the implicit tree in order, handing out the sorted elements
+// (and then copies of the largest one) to the slots as it reaches them.
+template <typename T>
+void VebSet<T>::fill(
+    unsigned int index, unsigned int depth, unsigned int* pos,
+    const T* sorted, unsigned int& next)
+{
+    if (depth > 0)
+    {
+        pos[depth] = positionOf(index, depth, pos);
+    }
+
+    if (depth + 1 < tree_height)
+    {
+        fill(2 * index, depth + 1, pos, sorted, next);
+    }
+
+    tree[pos[depth]] = sorted[next < tree_size ? next : tree_size - 1];
+    ++next;
+
+    if (depth + 1 < tree_height)
+    {
+        fill(2 * index + 1, depth + 1, pos, sorted, next);
+    }
+}
+
+
+template <typename T>
+void VebSet<T>::thaw()
+{
+    unsigned int slots = static_cast<unsigned int>((1ull << tree_height) - 1);
+
+    pending.reserve(tree_size);
+
+    for (unsigned int i = 0; i < slots; ++i)
+    {
+        pending.add(tree[i]);
+    }
+
+    delete[] tree;
+    tree = nullptr;
+}
+
+
+template <typename T>
+void VebSet<T>::copyAll(const VebSet& s)
+{
+    tree = nullptr;
+    tree_size = s.tree_size;
+    tree_height = s.tree_height;
+
+    for (unsigned int d = 0; d < MAX_HEIGHT; ++d)
+    {
+        top_size[d] = s.top_size[d];
+        bottom_size[d] = s.bottom_size[d];
+        top_depth[d] = s.top_depth[d];
+    }
+
+    if (s.tree != nullptr)
+    {
+        unsigned int slots = static_cast<unsigned int>((1ull << tree_height) - 1);
+        tree = new T[slots];
+
+        for (unsigned int i = 0; i < slots; ++i)
+        {
+            tree[i] = s.tree[i];
+        }
+    }
+}
+
+
+
+#endif // VEBSET_HPP
@@ -6,6 +6,8 @@
 // Replace and/or augment the implementations below as needed to meet
 // the requirements.
 
+#include <algorithm>
+#include <string_view>
 #include "WordChecker.hpp"
 using namespace std; 
 
@@ -85,19 +87,23 @@ std::vector<std::string> WordChecker::findSuggestions(const std::string& word) c
 		}
 	}
 
-	/*splitting the word into a pair of words by adding a space in between each adjacent pair.*/
+	/*splitting the word into a pair of words by adding a space in between each adjacent pair.
+	  Both halves are looked up as views into the word, so nothing is built unless they're found.*/
+	string_view whole{word};
 	for(int i=1; i<word.size(); i++)
 	{
-		string copy5=word; 
-		string subcopy1=copy5.substr(0,i);
-		string subcopy2=copy5.substr(i);
-		copy5=subcopy1+" "+subcopy2;
-		bool itemfound=(find(suggestion.begin(),suggestion.end(),copy5)!=suggestion.end()); 
-		if(wordExists(subcopy1)&&wordExists(subcopy2)&&(!itemfound))
+		string_view subcopy1=whole.substr(0,i);
+		string_view subcopy2=whole.substr(i);
+		if(words.containsView(subcopy1)&&words.containsView(subcopy2))
 		{
-			suggestion.push_back(copy5);
+			string copy5=word;
+			copy5.insert(i,1,' ');
+			bool itemfound=(find(suggestion.begin(),suggestion.end(),copy5)!=suggestion.end()); 
+			if(!itemfound)
+			{
+				suggestion.push_back(copy5);
+			}
 		}
-
 	}
 
     return suggestion; 
@@ -10,12 +10,37 @@
 #ifndef SET_HPP
 #define SET_HPP
 
+#include <string>
+#include <string_view>
+
+
+
+// SetKeyView<T>::type is the type that a Set<T> accepts in containsView().
+// For most types of elements, it's simply a reference to the element type.
+// For std::string, it's std::string_view, so that a caller can look up a
+// word that's part of some larger string without building a new one.
+
+template <typename T>
+struct SetKeyView
+{
+    typedef const T& type;
+};
+
+
+template <>
+struct SetKeyView<std::string>
+{
+    typedef std::string_view type;
+};
+
 
 
 template <typename T>
 class Set
 {
 public:
+    typedef typename SetKeyView<T>::type KeyView;
+
     // The destructor is declared here mainly so we can assure that it will
     // be virtual.  This is important because we'll be deriving from this class
     // template.
@@ -38,8 +63,36 @@ public:
     virtual bool contains(const T& element) const = 0;
 
 
+    // containsView() is equivalent to contains(), except that it accepts
+    // a KeyView of the element.  Implementations that can compare and hash
+    // a KeyView directly should override this; by default, it builds an
+    // element from the view and calls contains().
+    virtual bool containsView(KeyView element) const
+    {
+        return contains(T{element});
+    }
+
+
     // size() returns the number of elements in the set.
     virtual unsigned int size() const = 0;
+
+
+    // reserve() is a hint that the set is about to hold at least the given
+    // number of elements, so that it can size its storage once up front
+    // rather than growing repeatedly.  Implementations that have no use for
+    // the hint needn't override this; by default, it does nothing.
+    virtual void reserve(unsigned int /*count*/)
+    {
+    }
+
+
+    // freeze() is a hint that no more elements will be added to the set for
+    // a while, so that it can reorganize itself into a form that's faster
+    // to search.  Adding an element after the set is frozen is still legal,
+    // though it may be expensive.  By default, it does nothing.
+    virtual void freeze()
+    {
+    }
 };
 
 
@@ -10,16 +10,29 @@
 #include "SpellCheckShell.hpp"
 #include "AVLSet.hpp"
 #include "BSTSet.hpp"
+#include "BTreeSet.hpp"
+#include "BloomFilterSet.hpp"
+#include "CompactAVLSet.hpp"
+#include "DawgSet.hpp"
+#include "DoubleArraySet.hpp"
 #include "EmptySet.hpp"
+#include "EytzingerSet.hpp"
 #include "HashSet.hpp"
 #include "ListSet.hpp"
 #include "OutputSpellCheckerListener.hpp"
+#include "PerfectHashSet.hpp"
+#include "PersistentAVLSet.hpp"
+#include "RadixSet.hpp"
+#include "RobinHoodSet.hpp"
 #include "Set.hpp"
 #include "SkipListSet.hpp"
 #include "SpellChecker.hpp"
+#include "SplaySet.hpp"
 #include "Stopwatch.hpp"
 #include "StringHashing.hpp"
+#include "SwissSet.hpp"
 #include "TextFileReader.hpp"
+#include "VebSet.hpp"
 #include "WordChecker.hpp"
 #include "WordSetLoader.hpp"
 
@@ -50,7 +63,14 @@ namespace
 
     std::unique_ptr<Set<std::string>> makeWordSet(const std::string& setType)
     {
-        if (setType == "AVL")
+        // "BLOOM" followed by any other type puts a Bloom filter in front of
+        // a set of that type.
+        if (setType.compare(0, 6, "BLOOM ") == 0)
+        {
+            return std::make_unique<BloomFilterSet<std::string, HashStringAsWyhash>>(
+                makeWordSet(setType.substr(6)));
+        }
+        else if (setType == "AVL")
         {
             return std::make_unique<AVLSet<std::string>>();
         }
@@ -58,30 +78,98 @@ namespace
         {
             return std::make_unique<BSTSet<std::string>>();
         }
+        else if (setType == "BTREE")
+        {
+            return std::make_unique<BTreeSet<std::string>>();
+        }
+        else if (setType == "COMPACT AVL")
+        {
+            return std::make_unique<CompactAVLSet>();
+        }
+        else if (setType == "DAWG")
+        {
+            return std::make_unique<DawgSet>();
+        }
+        else if (setType == "DOUBLE ARRAY")
+        {
+            return std::make_unique<DoubleArraySet>();
+        }
         else if (setType == "EMPTY")
         {
             return std::make_unique<EmptySet<std::string>>();
         }
+        else if (setType == "EYTZINGER")
+        {
+            return std::make_unique<EytzingerSet<std::string>>();
+        }
+        else if (setType == "FROZEN HASH")
+        {
+            return std::make_unique<PerfectHashSet>();
+        }
         else if (setType == "HASH ZERO")
         {
-            return std::make_unique<HashSet<std::string>>(hashStringAsZero);
+            return std::make_unique<HashSet<std::string, HashStringAsZero>>();
         }
         else if (setType == "HASH SUM")
         {
-            return std::make_unique<HashSet<std::string>>(hashStringAsSum);
+            return std::make_unique<HashSet<std::string, HashStringAsSum>>();
         }
         else if (setType == "HASH PRODUCT")
         {
-            return std::make_unique<HashSet<std::string>>(hashStringAsProduct);
+            return std::make_unique<HashSet<std::string, HashStringAsProduct>>();
+        }
+        else if (setType == "HASH FNV1A")
+        {
+            return std::make_unique<HashSet<std::string, HashStringAsFnv1a>>();
+        }
+        else if (setType == "HASH WYHASH")
+        {
+            return std::make_unique<HashSet<std::string, HashStringAsWyhash>>();
+        }
+        else if (setType == "HASH CRC32C")
+        {
+            return std::make_unique<HashSet<std::string, HashStringAsCrc32c>>();
+        }
+        else if (setType == "HASH SIPHASH")
+        {
+            return std::make_unique<HashSet<std::string, HashStringAsSipHash>>();
+        }
+        else if (setType == "HASH PRODUCT INCREMENTAL")
+        {
+            return std::make_unique<HashSet<std::string, HashStringAsProduct>>(HashStringAsProduct{}, true);
+        }
+        else if (setType == "HASH SWISS")
+        {
+            return std::make_unique<SwissSet<std::string, HashStringAsProduct>>();
+        }
+        else if (setType == "HASH ROBINHOOD")
+        {
+            return std::make_unique<RobinHoodSet<std::string, HashStringAsProduct>>();
         }
         else if (setType == "LIST")
         {
             return std::make_unique<ListSet<std::string>>();
         }
+        else if (setType == "PERSISTENT AVL")
+        {
+            return std::make_unique<PersistentAVLSet<std::string>>();
+        }
+        else if (setType == "RADIX")
+        {
+            return std::make_unique<RadixSet>();
+        }
         else if (setType == "SKIPLIST")
         {
             return std::make_unique<SkipListSet<std::string>>();
         }
+        else if (setType == "SPLAY")
+        {
+            return std::make_unique<SplaySet<std::string>>();
+        }
+        else if (setType == "VEB")
+        {
+            return std::make_unique<VebSet<std::string>>();
+        }
         else
         {
             throw SpellCheckShell::ShellException{"Invalid search structure type: " + setType};
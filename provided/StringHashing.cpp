@@ -3,6 +3,7 @@
 // ICS 46 Spring 2017
 // Project #3: Set the Controls for the Heart of the Sun
 
+#include <random>
 #include "StringHashing.hpp"
 
 
@@ -10,9 +11,9 @@
 // This hash function returns zero for all strings.  As you might imagine,
 // this isn't a very good choice in practice; try it and see what happens.
 
-unsigned int hashStringAsZero(const std::string& word)
+unsigned int hashStringAsZero(std::string_view word)
 {
-    return 0;
+    return HashStringAsZero{}(word);
 }
 
 
@@ -20,33 +21,123 @@ unsigned int hashStringAsZero(const std::string& word)
 // character codes of each character in the string.  Consider whether
 // this is a good approach, and compare it to the hash function below.
 
-unsigned int hashStringAsSum(const std::string& word)
+unsigned int hashStringAsSum(std::string_view word)
 {
-    unsigned int hash = 0;
+    return HashStringAsSum{}(word);
+}
+
+
+// This hash function returns a hash value calculated in a way that
+// includes multiplication by the prime number 37 repeatedly.  Consider
+// why this approach might be better or worse than the one above.
+
+unsigned int hashStringAsProduct(std::string_view word)
+{
+    return HashStringAsProduct{}(word);
+}
+
+
+
+// This hash function is FNV-1a, which combines each character into the
+// hash using an exclusive or followed by a multiplication by a prime.
+
+unsigned int hashStringAsFnv1a(std::string_view word)
+{
+    return HashStringAsFnv1a{}(word);
+}
+
+
+// This hash function is based on wyhash, which hashes eight bytes at a
+// time using wide multiplications; see hashStringAsWyhash64().
+
+unsigned int hashStringAsWyhash(std::string_view word)
+{
+    return HashStringAsWyhash{}(word);
+}
+
+
+// This hash function is the CRC32C checksum of the string.  It uses the
+// processor's CRC32 instruction when SSE4.2 is available and a table of
+// precomputed remainders otherwise.
+
+namespace
+{
+    struct Crc32cTable
+    {
+        std::uint32_t entries[256];
+
+        Crc32cTable()
+        {
+            for (std::uint32_t i = 0; i < 256; ++i)
+            {
+                std::uint32_t crc = i;
+
+                for (int bit = 0; bit < 8; ++bit)
+                {
+                    crc = (crc & 1) ? (crc >> 1) ^ 0x82f63b78u : crc >> 1;
+                }
+
+                entries[i] = crc;
+            }
+        }
+    };
+}
+
+
+unsigned int hashStringAsCrc32c(std::string_view word)
+{
+#if defined(__SSE4_2__)
+    return HashStringAsCrc32c{}(word);
+#else
+    static const Crc32cTable table;
+
+    std::uint32_t crc = 0xffffffffu;
 
     for (size_t i = 0; i < word.length(); ++i)
     {
-        hash += static_cast<unsigned int>(word[i]);
+        crc = table.entries[(crc ^ static_cast<unsigned char>(word[i])) & 0xff] ^ (crc >> 8);
     }
 
-    return hash;
+    return crc ^ 0xffffffffu;
+#endif
 }
 
 
-// This hash function returns a hash value calculated in a way that
-// includes multiplication by the prime number 37 repeatedly.  Consider
-// why this approach might be better or worse than the one above.
+// randomHashSeed() draws its values from the operating system's source of
+// randomness, via std::random_device, so they differ from run to run.
 
-unsigned int hashStringAsProduct(const std::string& word)
+std::uint64_t randomHashSeed()
 {
-    unsigned int hash = 0;
+    std::random_device device;
+    return (static_cast<std::uint64_t>(device()) << 32) ^ device();
+}
 
-    for (size_t i = 0; i < word.length(); ++i)
+
+namespace
+{
+    struct ProcessHashKey
+    {
+        std::uint64_t k0 = randomHashSeed();
+        std::uint64_t k1 = randomHashSeed();
+    };
+
+
+    const ProcessHashKey& processHashKey()
     {
-        hash *= 37;
-        hash += static_cast<unsigned int>(word[i]);
+        static const ProcessHashKey key;
+        return key;
     }
-    
-    return hash;
 }
 
+
+HashStringAsSipHash::HashStringAsSipHash()
+    : k0{processHashKey().k0}, k1{processHashKey().k1}
+{
+}
+
+
+void HashStringAsSipHash::reseed()
+{
+    k0 = randomHashSeed();
+    k1 = randomHashSeed();
+}
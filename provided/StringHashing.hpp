@@ -4,17 +4,364 @@
 // Project #3: Set the Controls for the Heart of the Sun
 //
 // A collection of hash functions that are capable of hashing strings.
+// They accept a std::string_view, so that they can hash either a whole
+// std::string or a piece of one without copying it.
 
 #ifndef STRINGHASHING_HPP
 #define STRINGHASHING_HPP
 
-#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
 
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
 
 
-unsigned int hashStringAsZero(const std::string& word);
-unsigned int hashStringAsSum(const std::string& word);
-unsigned int hashStringAsProduct(const std::string& word);
+
+unsigned int hashStringAsZero(std::string_view word);
+unsigned int hashStringAsSum(std::string_view word);
+unsigned int hashStringAsProduct(std::string_view word);
+unsigned int hashStringAsFnv1a(std::string_view word);
+unsigned int hashStringAsWyhash(std::string_view word);
+unsigned int hashStringAsCrc32c(std::string_view word);
+
+
+// hashStringAsWyhash64() is the full 64-bit hash from which
+// hashStringAsWyhash() is derived, for callers that need more than 32 bits
+// of hash or want to supply their own seed.
+inline std::uint64_t hashStringAsWyhash64(std::string_view word, std::uint64_t seed = 0);
+
+
+// hashStringAsSipHash() is SipHash-1-3, a keyed hash function: without
+// knowing the 128-bit key (k0, k1), nobody can predict which strings will
+// collide.  randomHashSeed() returns a fresh, unpredictable 64-bit value
+// suitable for use as half of a key.
+inline std::uint64_t hashStringAsSipHash(std::string_view word, std::uint64_t k0, std::uint64_t k1);
+std::uint64_t randomHashSeed();
+
+
+
+// Each of the hash functions above is also available as a "hasher": a
+// type whose call operator is defined here in the header, so that a hash
+// set that takes it as its Hasher template argument can have the hashing
+// inlined into its own loops rather than making an indirect call through
+// a std::function.  The functions above simply call these.
+
+struct HashStringAsZero
+{
+    unsigned int operator()(std::string_view /*word*/) const
+    {
+        return 0;
+    }
+};
+
+
+struct HashStringAsSum
+{
+    unsigned int operator()(std::string_view word) const
+    {
+        unsigned int hash = 0;
+
+        for (size_t i = 0; i < word.length(); ++i)
+        {
+            hash += static_cast<unsigned int>(word[i]);
+        }
+
+        return hash;
+    }
+};
+
+
+struct HashStringAsProduct
+{
+    unsigned int operator()(std::string_view word) const
+    {
+        unsigned int hash = 0;
+
+        for (size_t i = 0; i < word.length(); ++i)
+        {
+            hash *= 37;
+            hash += static_cast<unsigned int>(word[i]);
+        }
+
+        return hash;
+    }
+};
+
+
+
+
+// FNV-1a folds each byte into the hash with an exclusive or and then
+// multiplies by a prime, so every byte affects every higher bit of the
+// result.  It's still one byte at a time, but it's cheap and, unlike the
+// sum, it distinguishes anagrams.
+
+struct HashStringAsFnv1a
+{
+    unsigned int operator()(std::string_view word) const
+    {
+        std::uint32_t hash = 2166136261u;
+
+        for (size_t i = 0; i < word.length(); ++i)
+        {
+            hash ^= static_cast<unsigned char>(word[i]);
+            hash *= 16777619u;
+        }
+
+        return hash;
+    }
+};
+
+
+// The "wyhash" family consumes its input eight or sixteen bytes at a time
+// and mixes them with 64x64-to-128-bit multiplications, which modern
+// processors do in a handful of cycles.  Words of up to sixteen characters
+// -- nearly all of them -- are hashed with just two multiplications.
+
+namespace StringHashingDetail
+{
+    constexpr std::uint64_t WYHASH_SECRET[4] = {
+        0xa0761d6478bd642full, 0xe7037ed1a0b428dbull,
+        0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull };
+
+
+    inline void multiply128(std::uint64_t& a, std::uint64_t& b)
+    {
+#if defined(__SIZEOF_INT128__)
+        __uint128_t product = static_cast<__uint128_t>(a) * b;
+        a = static_cast<std::uint64_t>(product);
+        b = static_cast<std::uint64_t>(product >> 64);
+#else
+        std::uint64_t ha = a >> 32, hb = b >> 32, la = a & 0xffffffffu, lb = b & 0xffffffffu;
+        std::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+        std::uint64_t t = rl + (rm0 << 32);
+        std::uint64_t carry = t < rl;
+        std::uint64_t low = t + (rm1 << 32);
+        carry += low < t;
+        b = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+        a = low;
+#endif
+    }
+
+
+    inline std::uint64_t mix(std::uint64_t a, std::uint64_t b)
+    {
+        multiply128(a, b);
+        return a ^ b;
+    }
+
+
+    inline std::uint64_t read8(const char* p)
+    {
+        std::uint64_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+
+    inline std::uint64_t read4(const char* p)
+    {
+        std::uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+
+    inline std::uint64_t read3(const char* p, size_t length)
+    {
+        return (static_cast<std::uint64_t>(static_cast<unsigned char>(p[0])) << 16)
+            | (static_cast<std::uint64_t>(static_cast<unsigned char>(p[length >> 1])) << 8)
+            | static_cast<unsigned char>(p[length - 1]);
+    }
+}
+
+
+inline std::uint64_t hashStringAsWyhash64(std::string_view word, std::uint64_t seed)
+{
+    using namespace StringHashingDetail;
+
+    const char* p = word.data();
+    size_t length = word.length();
+    std::uint64_t a;
+    std::uint64_t b;
+
+    seed ^= mix(seed ^ WYHASH_SECRET[0], WYHASH_SECRET[1]);
+
+    if (length <= 16)
+    {
+        if (length >= 4)
+        {
+            size_t middle = (length >> 3) << 2;
+            a = (read4(p) << 32) | read4(p + middle);
+            b = (read4(p + length - 4) << 32) | read4(p + length - 4 - middle);
+        }
+        else if (length > 0)
+        {
+            a = read3(p, length);
+            b = 0;
+        }
+        else
+        {
+            a = 0;
+            b = 0;
+        }
+    }
+    else
+    {
+        size_t remaining = length;
+
+        while (remaining > 16)
+        {
+            seed = mix(read8(p) ^ WYHASH_SECRET[1], read8(p + 8) ^ seed);
+            p += 16;
+            remaining -= 16;
+        }
+
+        a = read8(p + remaining - 16);
+        b = read8(p + remaining - 8);
+    }
+
+    a ^= WYHASH_SECRET[1];
+    b ^= seed;
+    multiply128(a, b);
+
+    return mix(a ^ WYHASH_SECRET[0] ^ length, b ^ WYHASH_SECRET[1]);
+}
+
+
+struct HashStringAsWyhash
+{
+    unsigned int operator()(std::string_view word) const
+    {
+        std::uint64_t hash = hashStringAsWyhash64(word, 0);
+        return static_cast<unsigned int>(hash ^ (hash >> 32));
+    }
+};
+
+
+// CRC32C is computed by a dedicated instruction on processors with SSE4.2,
+// eight bytes per instruction.  Where the compiler can't assume SSE4.2,
+// the hasher calls hashStringAsCrc32c(), which uses a lookup table.
+
+struct HashStringAsCrc32c
+{
+    unsigned int operator()(std::string_view word) const
+    {
+#if defined(__SSE4_2__)
+        const char* p = word.data();
+        size_t length = word.length();
+        std::uint64_t crc = 0xffffffffu;
+
+        for (; length >= 8; p += 8, length -= 8)
+        {
+            crc = _mm_crc32_u64(crc, StringHashingDetail::read8(p));
+        }
+
+        std::uint32_t crc32 = static_cast<std::uint32_t>(crc);
+
+        for (; length > 0; ++p, --length)
+        {
+            crc32 = _mm_crc32_u8(crc32, static_cast<unsigned char>(*p));
+        }
+
+        return crc32 ^ 0xffffffffu;
+#else
+        return hashStringAsCrc32c(word);
+#endif
+    }
+};
+
+
+
+
+// SipHash-1-3 runs one compression round per eight bytes of input and
+// three finalization rounds.  It's slower than the unkeyed hashes above,
+// but it's the one to use when the strings being hashed may have been
+// chosen by an adversary.
+
+namespace StringHashingDetail
+{
+    inline std::uint64_t rotate(std::uint64_t x, int bits)
+    {
+        return (x << bits) | (x >> (64 - bits));
+    }
+
+
+    inline void sipRound(std::uint64_t& v0, std::uint64_t& v1, std::uint64_t& v2, std::uint64_t& v3)
+    {
+        v0 += v1; v1 = rotate(v1, 13); v1 ^= v0; v0 = rotate(v0, 32);
+        v2 += v3; v3 = rotate(v3, 16); v3 ^= v2;
+        v0 += v3; v3 = rotate(v3, 21); v3 ^= v0;
+        v2 += v1; v1 = rotate(v1, 17); v1 ^= v2; v2 = rotate(v2, 32);
+    }
+}
+
+
+inline std::uint64_t hashStringAsSipHash(std::string_view word, std::uint64_t k0, std::uint64_t k1)
+{
+    using namespace StringHashingDetail;
+
+    std::uint64_t v0 = k0 ^ 0x736f6d6570736575ull;
+    std::uint64_t v1 = k1 ^ 0x646f72616e646f6dull;
+    std::uint64_t v2 = k0 ^ 0x6c7967656e657261ull;
+    std::uint64_t v3 = k1 ^ 0x7465646279746573ull;
+
+    const char* p = word.data();
+    size_t length = word.length();
+    size_t blocks = length & ~static_cast<size_t>(7);
+
+    for (size_t i = 0; i < blocks; i += 8)
+    {
+        std::uint64_t m = read8(p + i);
+        v3 ^= m;
+        sipRound(v0, v1, v2, v3);
+        v0 ^= m;
+    }
+
+    std::uint64_t last = static_cast<std::uint64_t>(length) << 56;
+
+    for (size_t i = blocks; i < length; ++i)
+    {
+        last |= static_cast<std::uint64_t>(static_cast<unsigned char>(p[i])) << (8 * (i - blocks));
+    }
+
+    v3 ^= last;
+    sipRound(v0, v1, v2, v3);
+    v0 ^= last;
+
+    v2 ^= 0xff;
+    sipRound(v0, v1, v2, v3);
+    sipRound(v0, v1, v2, v3);
+    sipRound(v0, v1, v2, v3);
+
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+
+// A HashStringAsSipHash hasher keys SipHash-1-3 with a random key, drawn
+// once per process and shared by every hasher that hasn't been reseeded.
+// reseed() gives a hasher a fresh random key of its own.
+
+class HashStringAsSipHash
+{
+public:
+    HashStringAsSipHash();
+
+    unsigned int operator()(std::string_view word) const
+    {
+        std::uint64_t hash = hashStringAsSipHash(word, k0, k1);
+        return static_cast<unsigned int>(hash ^ (hash >> 32));
+    }
+
+    void reseed();
+
+private:
+    std::uint64_t k0;
+    std::uint64_t k1;
+};
 
 
 
@@ -71,13 +71,13 @@ void TextFileReader::advanceToNextLine()
 }
 
 
-std::string TextFileReader::currentLine() const
+const std::string& TextFileReader::currentLine() const
 {
     return line;
 }
 
 
-std::string TextFileReader::currentWord() const
+const std::string& TextFileReader::currentWord() const
 {
     return word;
 }
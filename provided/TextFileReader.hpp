@@ -23,8 +23,8 @@ public:
     bool noMoreWords() const;
     void advanceToNextWord();
 
-    std::string currentLine() const;
-    std::string currentWord() const;
+    const std::string& currentLine() const;
+    const std::string& currentWord() const;
 
 private:
     std::ifstream textFile;
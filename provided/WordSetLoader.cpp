@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <cctype>
 #include <fstream>
+#include <iterator>
 #include "WordSetLoader.hpp"
 
 
@@ -14,6 +15,17 @@ void WordSetLoader::load(const std::string& wordFilePath, Set<std::string>& word
 {
     std::ifstream wordFile{wordFilePath};
 
+    // Counting the lines first lets the set size itself once, rather than
+    // growing repeatedly as the words arrive.  (Blank or duplicate lines
+    // make this an overestimate, which is harmless.)
+    std::size_t lineCount = std::count(
+        std::istreambuf_iterator<char>{wordFile}, std::istreambuf_iterator<char>{}, '\n');
+
+    wordSet.reserve(static_cast<unsigned int>(lineCount + 1));
+
+    wordFile.clear();
+    wordFile.seekg(0);
+
     std::string word;
 
     while (std::getline(wordFile, word))
@@ -30,5 +42,9 @@ void WordSetLoader::load(const std::string& wordFilePath, Set<std::string>& word
 
         wordSet.add(word);
     }
+
+    // The words are only searched from here on, so the set may as well
+    // settle into whatever form makes that fastest.
+    wordSet.freeze();
 }
 
@@ -0,0 +1,209 @@
+// SkipListSetConcurrencyTest.cpp
+//
+// ICS 46 Spring 2017
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// This program checks that a SkipListSet can be added to and searched by
+// several threads at once.  Writer threads add interleaved (and partly
+// overlapping) ranges of words, while reader threads check, over and over,
+// that every word a writer has finished adding is found, that no word that
+// was never added is found, that size() never decreases, and that the
+// bottom level is always in strictly ascending order.  Once they're done,
+// the set must hold exactly the words that were added.
+//
+// It's a standalone program; build it with the core and provided
+// directories on the include path, and with threads enabled, e.g.:
+//
+//     g++ -std=c++17 -O2 -pthread -I core -I provided test/SkipListSetConcurrencyTest.cpp
+//
+// Building it with -fsanitize=thread checks for data races, too.  It prints
+// a line for each failure it sees, and exits with a nonzero status if there
+// were any.
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SkipListSet.hpp"
+
+
+
+namespace
+{
+    constexpr unsigned int WRITERS = 4;
+    constexpr unsigned int READERS = 4;
+    constexpr unsigned int WORDS_PER_WRITER = 5000;
+
+    // Each writer adds the words for i * WRITERS + writer, and then the
+    // words for the writer after it, so every word is added twice, by two
+    // threads that may well be adding it at the same time.
+    constexpr unsigned int WORD_COUNT = WRITERS * WORDS_PER_WRITER;
+
+
+    std::string wordFor(unsigned int n)
+    {
+        return "W" + std::to_string(n);
+    }
+
+
+    std::string missingWordFor(unsigned int n)
+    {
+        return "X" + std::to_string(n);
+    }
+
+
+    std::atomic<unsigned int> failures{0};
+
+
+    void fail(const std::string& message)
+    {
+        if (failures.fetch_add(1) < 20)
+        {
+            std::cout << "FAILED: " << message << std::endl;
+        }
+    }
+
+
+    void write(SkipListSet<std::string>& set, unsigned int writer, std::atomic<unsigned int>* progress)
+    {
+        for (unsigned int i = 0; i < WORDS_PER_WRITER; ++i)
+        {
+            set.add(wordFor(i * WRITERS + writer));
+            progress[writer].store(i + 1, std::memory_order_release);
+
+            set.add(wordFor(i * WRITERS + (writer + 1) % WRITERS));
+        }
+    }
+
+
+    void read(
+        const SkipListSet<std::string>& set, unsigned int reader,
+        const std::atomic<unsigned int>* progress, const std::atomic<bool>& done)
+    {
+        unsigned int lastSize = 0;
+
+        for (unsigned int round = 0; !done.load(); ++round)
+        {
+            unsigned int size = set.size();
+
+            if (size < lastSize)
+            {
+                fail("size() went from " + std::to_string(lastSize) + " to " + std::to_string(size));
+            }
+
+            lastSize = size;
+
+            for (unsigned int writer = 0; writer < WRITERS; ++writer)
+            {
+                unsigned int added = progress[writer].load(std::memory_order_acquire);
+
+                for (unsigned int i = reader; i < added; i += 97)
+                {
+                    if (!set.contains(wordFor(i * WRITERS + writer)))
+                    {
+                        fail("an added word wasn't found: " + wordFor(i * WRITERS + writer));
+                    }
+                }
+            }
+
+            for (unsigned int i = reader; i < WORD_COUNT; i += 101)
+            {
+                if (set.contains(missingWordFor(i)))
+                {
+                    fail("a word that was never added was found: " + missingWordFor(i));
+                }
+            }
+
+            if (round % 8 == 0)
+            {
+                const std::string* previous = nullptr;
+
+                for (const std::string& word : set)
+                {
+                    if (previous != nullptr && !(*previous < word))
+                    {
+                        fail("the bottom level is out of order at " + word);
+                    }
+
+                    previous = &word;
+                }
+            }
+        }
+    }
+}
+
+
+
+int main()
+{
+    SkipListSet<std::string> set;
+    std::atomic<unsigned int> progress[WRITERS];
+    std::atomic<bool> done{false};
+
+    for (unsigned int writer = 0; writer < WRITERS; ++writer)
+    {
+        progress[writer].store(0);
+    }
+
+    std::vector<std::thread> readers;
+
+    for (unsigned int reader = 0; reader < READERS; ++reader)
+    {
+        readers.emplace_back(read, std::cref(set), reader, progress, std::cref(done));
+    }
+
+    std::vector<std::thread> writers;
+
+    for (unsigned int writer = 0; writer < WRITERS; ++writer)
+    {
+        writers.emplace_back(write, std::ref(set), writer, progress);
+    }
+
+    for (std::thread& writer : writers)
+    {
+        writer.join();
+    }
+
+    done.store(true);
+
+    for (std::thread& reader : readers)
+    {
+        reader.join();
+    }
+
+    if (set.size() != WORD_COUNT)
+    {
+        fail("size() is " + std::to_string(set.size()) + " rather than " + std::to_string(WORD_COUNT));
+    }
+
+    for (unsigned int n = 0; n < WORD_COUNT; ++n)
+    {
+        if (!set.contains(wordFor(n)))
+        {
+            fail("an added word is missing at the end: " + wordFor(n));
+        }
+    }
+
+    unsigned int visited = 0;
+
+    for (auto i = set.begin(); i != set.end(); ++i)
+    {
+        ++visited;
+    }
+
+    if (visited != WORD_COUNT)
+    {
+        fail("iterating visits " + std::to_string(visited) + " words rather than " + std::to_string(WORD_COUNT));
+    }
+
+    if (failures.load() != 0)
+    {
+        std::cout << failures.load() << " failure(s)" << std::endl;
+        return 1;
+    }
+
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
+